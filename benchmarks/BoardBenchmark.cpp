@@ -0,0 +1,609 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "../logic/Board.h"
+#include "../logic/BoardBatch.h"
+#include "../logic/Expectiminimax.h"
+#include "../logic/Mcts.h"
+#include "../logic/MoveFilter.h"
+#include "../logic/NeuralNet.h"
+#include "../logic/NodeArena.h"
+#include "../logic/OutcomeKernels.h"
+#include "../logic/Perft.h"
+#include "../logic/PlayTree.h"
+#include "../logic/Rng.h"
+#include "../logic/Rollout.h"
+#include "../logic/TdGammonEncoder.h"
+#include "../logic/TranspositionTable.h"
+
+// Curated positions, in the 31 integer format of the Board array constructor:
+// 24 points (positive for player 1, negative for player 2), bar of player 1, bar of player 2,
+// four dice (-1 for no die) and the current player.
+struct NamedPosition {
+    const char* name;
+    int state[31];
+};
+
+const NamedPosition POSITIONS[] = {
+    {"opening 3-1", {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                     -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                     0, 0, 3, 1, -1, -1, 1}},
+    {"opening 6-6", {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                     -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                     0, 0, 6, 6, 6, 6, 1}},
+    {"contact 4-2", {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 3,
+                     -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                     0, 0, 4, 2, -1, -1, 1}},
+    {"contact 3-3", {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 3,
+                     -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                     0, 0, 3, 3, 3, 3, 1}},
+    {"contact player 2 5-1", {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 3,
+                              -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                              0, 0, 5, 1, -1, -1, -1}},
+    {"bar entry 5-3", {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 1,
+                       -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                       2, 0, 5, 3, -1, -1, 1}},
+    {"bar entry 2-2", {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 1,
+                       -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                       2, 0, 2, 2, 2, 2, 1}},
+    {"bear-off 6-5", {-3, -3, -3, -2, -2, -2, 0, 0, 0, 0, 0, 0,
+                      0, 0, 0, 0, 0, 0, 3, 2, 3, 3, 2, 2,
+                      0, 0, 6, 5, -1, -1, 1}},
+    {"bear-off 4-4", {-3, -3, -3, -2, -2, -2, 0, 0, 0, 0, 0, 0,
+                      0, 0, 0, 0, 0, 0, 3, 2, 3, 3, 2, 2,
+                      0, 0, 4, 4, 4, 4, 1}},
+};
+
+const int POSITION_COUNT = sizeof(POSITIONS) / sizeof(POSITIONS[0]);
+
+// Registers one instance of a benchmark per curated position
+void allPositions(benchmark::internal::Benchmark* b) {
+    for (int i = 0; i < POSITION_COUNT; ++i) {
+        b->Arg(i);
+    }
+}
+
+Board positionBoard(benchmark::State& state) {
+    const NamedPosition& position = POSITIONS[state.range(0)];
+    state.SetLabel(position.name);
+    return Board(position.state);
+}
+
+
+// Full legality search for a turn: every ordering of the dice, max-dice and higher-die rules.
+// This is what the first validMoves() call of a turn costs.
+static void BM_PlayTreeBuild(benchmark::State& state) {
+    Board board = positionBoard(state);
+    PlayTree tree;
+    for (auto _ : state) {
+        tree.build(board);
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["plays"] = (double)tree.playCount();
+}
+BENCHMARK(BM_PlayTreeBuild)->Apply(allPositions);
+
+// validMoves() through the public API once the turn has been searched (per-thread cache hit)
+static void BM_ValidMoves(benchmark::State& state) {
+    Board board = positionBoard(state);
+    MoveList moves;
+    for (auto _ : state) {
+        board.validMoves(moves);
+        benchmark::DoNotOptimize(moves.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ValidMoves)->Apply(allPositions);
+
+// legalPlays() once the turn has been searched: walk of the cached play tree
+static void BM_LegalPlays(benchmark::State& state) {
+    Board board = positionBoard(state);
+    std::vector<Play> plays;
+    for (auto _ : state) {
+        board.legalPlays(plays);
+        benchmark::DoNotOptimize(plays.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LegalPlays)->Apply(allPositions);
+
+// Single die move generation, without the turn rules (one node of the legality search)
+static void BM_GenerateMoves(benchmark::State& state) {
+    Board board = positionBoard(state);
+    MoveList moves;
+    for (auto _ : state) {
+        (board.getCurrentPlayer() == 1) ? board.validMovesPlayer1(moves) : board.validMovesPlayer2(moves);
+        benchmark::DoNotOptimize(moves.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateMoves)->Apply(allPositions);
+
+// Applying and taking back every legal first move of the turn
+static void BM_DoUndoMove(benchmark::State& state) {
+    Board board = positionBoard(state);
+    MoveList moves;
+    board.validMoves(moves);
+    for (auto _ : state) {
+        for (const Move& m : moves) {
+            MoveUndo undo = board.doMove(m.from, m.distance);
+            benchmark::DoNotOptimize(board.getKey());
+            board.undoMove(undo);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_DoUndoMove)->Apply(allPositions);
+
+// move() on a fresh copy for every legal first move (includes the copy, see BM_BoardCopy)
+static void BM_Move(benchmark::State& state) {
+    Board board = positionBoard(state);
+    MoveList moves;
+    board.validMoves(moves);
+    for (auto _ : state) {
+        for (const Move& m : moves) {
+            Board copy(board);
+            copy.move(m.from, m.distance);
+            benchmark::DoNotOptimize(copy);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_Move)->Apply(allPositions);
+
+// step() on a fresh copy: legality check against the cached turn, move, and the change of
+// player (with a dice roll) when the turn ends
+static void BM_Step(benchmark::State& state) {
+    Board board = positionBoard(state);
+    Rng rng(1);
+    MoveList moves;
+    board.validMoves(moves);
+    for (auto _ : state) {
+        for (const Move& m : moves) {
+            Board copy(board);
+            copy.step(m.from, m.distance, rng);
+            benchmark::DoNotOptimize(copy);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_Step)->Apply(allPositions);
+
+static void BM_GetOutcome(benchmark::State& state) {
+    Board board = positionBoard(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(board.getOutcome());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetOutcome)->Apply(allPositions);
+
+static void BM_BoardCopy(benchmark::State& state) {
+    Board board = positionBoard(state);
+    for (auto _ : state) {
+        Board copy(board);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(Board));
+}
+BENCHMARK(BM_BoardCopy)->Arg(0);
+
+// Random games from the opening with a fixed seed; items are plies (single checker moves and passes)
+static void BM_RandomGame(benchmark::State& state) {
+    Rng rng(2024);
+    MoveList moves;
+    int64_t plies = 0;
+    for (auto _ : state) {
+        Board board(rng);
+        while (!board.isGameOver()) {
+            board.validMoves(moves);
+            if (moves.empty()) {
+                board.changePlayer(rng); // No legal move, the turn passes
+            } else {
+                const Move& m = moves[rng.below((uint32_t)moves.size())];
+                board.step(m.from, m.distance, rng);
+            }
+            plies++;
+        }
+        benchmark::DoNotOptimize(board.getOutcome());
+    }
+    state.SetItemsProcessed(plies);
+    state.counters["games"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["plies/game"] = (double)plies / (double)state.iterations();
+}
+BENCHMARK(BM_RandomGame)->Unit(benchmark::kMicrosecond);
+
+// Random games played a whole play at a time with legalPlays/applyPlay; items are turns
+static void BM_RandomGamePlays(benchmark::State& state) {
+    Rng rng(2024);
+    std::vector<Play> plays;
+    int64_t turns = 0;
+    for (auto _ : state) {
+        Board board(rng);
+        while (!board.isGameOver()) {
+            board.legalPlays(plays);
+            board.applyPlay(plays[rng.below((uint32_t)plays.size())], rng);
+            turns++;
+        }
+        benchmark::DoNotOptimize(board.getOutcome());
+    }
+    state.SetItemsProcessed(turns);
+    state.counters["games"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+    state.counters["turns/game"] = (double)turns / (double)state.iterations();
+}
+BENCHMARK(BM_RandomGamePlays)->Unit(benchmark::kMicrosecond);
+
+// Outcome of many games: one Board at a time, then the whole batch in struct-of-arrays layout
+static void BM_OutcomeBoards(benchmark::State& state) {
+    Rng rng(3);
+    std::vector<Board> boards;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        boards.emplace_back(rng);
+    }
+    std::vector<int8_t> outcomes(boards.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < boards.size(); ++i) {
+            outcomes[i] = (int8_t)boards[i].getOutcome();
+        }
+        benchmark::DoNotOptimize(outcomes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OutcomeBoards)->Arg(1024)->Arg(16384);
+
+static void BM_OutcomeBatch(benchmark::State& state) {
+    Rng rng(3);
+    BoardBatch batch((size_t)state.range(0), rng);
+    std::vector<int8_t> outcomes;
+    for (auto _ : state) {
+        batch.outcomeAll(outcomes);
+        benchmark::DoNotOptimize(outcomes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OutcomeBatch)->Arg(1024)->Arg(16384);
+
+// Each outcome kernel on its own over 16384 games: 0 scalar, 1 SSE2, 2 AVX2
+static void BM_OutcomeKernel(benchmark::State& state) {
+    const size_t games = 16384;
+    std::vector<uint32_t> occupied(games, 0x3F), opponent(games, 0xFC0000);
+    std::vector<uint8_t> onBoard(games, 15), bar(games, 0);
+    const OutcomeInputs in = {{occupied.data(), opponent.data()}, {onBoard.data(), onBoard.data()}, {bar.data(), bar.data()}};
+    OutcomeKernel kernel = outcomesScalar;
+#if defined(__x86_64__)
+    if (state.range(0) == 1) {
+        kernel = outcomesSse2;
+    } else if (state.range(0) == 2) {
+        if (!__builtin_cpu_supports("avx2")) {
+            state.SkipWithError("AVX2 not supported");
+            return;
+        }
+        kernel = outcomesAvx2;
+    }
+#endif
+    std::vector<int8_t> outcomes(games);
+    for (auto _ : state) {
+        kernel(in, outcomes.data(), games);
+        benchmark::DoNotOptimize(outcomes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * games);
+}
+BENCHMARK(BM_OutcomeKernel)->DenseRange(0, 2);
+
+// TD-Gammon sized networks (198 inputs, one hidden layer of range(1) units, 5 outputs) over 256
+// sparse inputs: 0 scalar, 1 SSE2, 2 AVX2 kernels
+static void BM_NeuralNet(benchmark::State& state) {
+    NeuralNet net;
+    net.create({NeuralNet::TD_GAMMON_INPUTS, (int)state.range(1), NeuralNet::MAX_OUTPUTS});
+    Rng rng(21);
+    net.randomize(rng, 0.5f);
+    net.setKernels(neuralKernelsScalar());
+#if defined(__x86_64__)
+    if (state.range(0) == 1) {
+        net.setKernels(neuralKernelsSse2());
+    } else if (state.range(0) == 2) {
+        if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+            state.SkipWithError("AVX2 not supported");
+            return;
+        }
+        net.setKernels(neuralKernelsAvx2());
+    }
+#endif
+    const size_t rows = 256;
+    std::vector<float> inputs(rows * NeuralNet::TD_GAMMON_INPUTS, 0.0f);
+    for (float& input : inputs) {
+        if (rng.below(6) == 0) {
+            input = 1.0f;
+        }
+    }
+    std::vector<float> outputs(rows * NeuralNet::MAX_OUTPUTS);
+    for (auto _ : state) {
+        net.evaluate(inputs.data(), rows, outputs.data());
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_NeuralNet)->ArgsProduct({{0, 1, 2}, {80, 128}});
+
+// TD-Gammon encodings of 1024 boards from random games: 0 scalar, 1 SSE2, 2 AVX2
+static void BM_TdGammonEncoder(benchmark::State& state) {
+    std::vector<Board> boards;
+    Rng rng(23);
+    std::vector<Play> plays;
+    Board board(rng);
+    while (boards.size() < 1024) {
+        if (board.isGameOver()) {
+            board = Board(rng);
+        }
+        boards.push_back(board);
+        board.legalPlays(plays);
+        board.applyPlay(plays[rng.below((uint32_t)plays.size())], rng);
+    }
+    TdGammonEncoder encoder = encodeTdGammonScalar;
+#if defined(__x86_64__)
+    if (state.range(0) == 1) {
+        encoder = encodeTdGammonSse2;
+    } else if (state.range(0) == 2) {
+        if (!__builtin_cpu_supports("avx2")) {
+            state.SkipWithError("AVX2 not supported");
+            return;
+        }
+        encoder = encodeTdGammonAvx2;
+    }
+#endif
+    std::vector<float> inputs(boards.size() * TD_GAMMON_INPUTS);
+    for (auto _ : state) {
+        encoder(boards.data(), boards.size(), inputs.data());
+        benchmark::DoNotOptimize(inputs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * boards.size());
+}
+BENCHMARK(BM_TdGammonEncoder)->DenseRange(0, 2);
+
+// Random games advanced in lockstep through a BoardBatch; items are turns
+static void BM_BatchRandomGames(benchmark::State& state) {
+    Rng rng(2024);
+    std::vector<std::vector<Play>> plays;
+    std::vector<Play> chosen((size_t)state.range(0));
+    std::vector<int8_t> outcomes;
+    int64_t turns = 0;
+    for (auto _ : state) {
+        BoardBatch batch((size_t)state.range(0), rng);
+        for (bool running = true; running; ) {
+            batch.legalPlaysAll(plays);
+            running = false;
+            for (size_t g = 0; g < plays.size(); ++g) {
+                if (!plays[g].empty()) {
+                    chosen[g] = plays[g][rng.below((uint32_t)plays[g].size())];
+                    running = true;
+                    turns++;
+                }
+            }
+            batch.applyAll(chosen, rng);
+        }
+        batch.outcomeAll(outcomes);
+        benchmark::DoNotOptimize(outcomes.data());
+    }
+    state.SetItemsProcessed(turns);
+}
+BENCHMARK(BM_BatchRandomGames)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// Every roll and every play from the opening for a number of turns; items are play tree nodes
+static void BM_Perft(benchmark::State& state) {
+    Board board(POSITIONS[0].state);
+    uint64_t nodes = 0;
+    for (auto _ : state) {
+        PerftResult r = perft(board, (int)state.range(0));
+        nodes += r.nodes;
+        benchmark::DoNotOptimize(r.leaves);
+    }
+    state.SetItemsProcessed((int64_t)nodes);
+}
+BENCHMARK(BM_Perft)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+
+// Random rollouts of the opening on a number of threads (games/sec should scale with cores)
+static void BM_Rollout(benchmark::State& state) {
+    RolloutOptions options;
+    options.games = 1296;
+    options.threads = (int)state.range(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rollout(Board(Rng::threadLocal()), randomPolicy, options).equity);
+        options.seed++;
+    }
+    state.counters["games"] = benchmark::Counter((double)(state.iterations() * options.games), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Rollout)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+// MCTS from the opening with one random playout per evaluation (simulations/sec)
+static void BM_Mcts(benchmark::State& state) {
+    Mcts::Options options;
+    options.iterations = (uint32_t)state.range(0);
+    Mcts mcts(randomRolloutEvaluator, options);
+    const Board board(POSITIONS[0].state); // Opening 3-1
+    for (auto _ : state) {
+        mcts.search(board);
+        benchmark::DoNotOptimize(mcts.bestPlay());
+    }
+    state.SetItemsProcessed(state.iterations() * options.iterations);
+    state.counters["nodes"] = (double)mcts.nodeCount();
+}
+BENCHMARK(BM_Mcts)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+// MCTS with a free evaluator (uniform priors, neutral value), so the tree itself is measured
+static void BM_MctsTree(benchmark::State& state) {
+    Mcts::Options options;
+    options.iterations = (uint32_t)state.range(0);
+    Mcts mcts([](const Board&, const std::vector<Play>& plays, float* priors, Rng&) {
+        std::fill(priors, priors + plays.size(), 1.0f);
+        return 0.0f;
+    }, options);
+    const Board board(POSITIONS[0].state); // Opening 3-1
+    for (auto _ : state) {
+        mcts.search(board);
+        benchmark::DoNotOptimize(mcts.bestPlay());
+    }
+    state.SetItemsProcessed(state.iterations() * options.iterations);
+    state.counters["nodes"] = (double)mcts.nodeCount();
+}
+BENCHMARK(BM_MctsTree)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Parallel MCTS scaling: threads, then 0 for tree parallel or 1 for root parallel (wall clock time)
+static void BM_MctsParallel(benchmark::State& state) {
+    Mcts::Options options;
+    options.iterations = 2000;
+    options.threads = (int)state.range(0);
+    options.parallelism = state.range(1) ? Mcts::Parallelism::ROOT : Mcts::Parallelism::TREE;
+    Mcts mcts(randomRolloutEvaluator, options);
+    const Board board(POSITIONS[0].state); // Opening 3-1
+    for (auto _ : state) {
+        mcts.search(board);
+        benchmark::DoNotOptimize(mcts.bestPlay());
+    }
+    state.SetItemsProcessed(state.iterations() * options.iterations);
+    state.counters["collisions"] = (double)mcts.collisions();
+}
+BENCHMARK(BM_MctsParallel)->ArgsProduct({{1, 2, 4, 8}, {0, 1}})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Pip count lead of the player on roll, the evaluator of the search benchmarks
+float pipEvaluator(const Board& board) {
+    const Position& position = board.position();
+    const int side = Position::sideIndex(board.getCurrentPlayer());
+    return std::tanh((float)(position.pips[side ^ 1] - position.pips[side] + 8) / 20.0f);
+}
+
+// Expectiminimax from a contact position with a pip count evaluator: depth in rolls, then the
+// pruning (0 for Star1 only, 1 for Star2, 2 for Star2 with static move ordering and a transposition table)
+static void BM_Expectiminimax(benchmark::State& state) {
+    TranspositionTable table(16);
+    Expectiminimax::Options options;
+    options.star2 = state.range(1) > 0;
+    if (state.range(1) == 2) {
+        options.table = &table;
+        options.ordering = Expectiminimax::staticOrdering(pipEvaluator);
+    }
+    Expectiminimax search(pipEvaluator, options);
+    const Board board(POSITIONS[2].state); // Contact 4-2
+    Play best;
+    for (auto _ : state) {
+        table.clear();
+        search.resetStats();
+        benchmark::DoNotOptimize(search.search(board, (int)state.range(0), best));
+    }
+    state.counters["evaluations"] = (double)search.stats().evaluations;
+    state.counters["nodes"] = (double)(search.stats().decisionNodes + search.stats().chanceNodes);
+}
+BENCHMARK(BM_Expectiminimax)->ArgsProduct({{1, 2}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+// 2-ply analysis of every play of a race through the default move filters (0-ply, 1-ply, 2-ply),
+// against scoring every play at 2-ply (Star2 with a table in both cases). The pip evaluator ties
+// every race play, so the first two stages keep their full window and the 2-ply stage has
+// candidates to score. Scoring every play at 2-ply takes seconds, so it is run once.
+static void BM_MoveFilter(benchmark::State& state) {
+    static const int RACE[31] = {0, 0, -2, -2, -3, -3, -2, -3, 0, 0, 0, 0,
+                                 0, 0, 0, 0, 3, 3, 2, 3, 2, 2, 0, 0,
+                                 0, 0, 6, 2, -1, -1, 1};
+    TranspositionTable table(16);
+    Expectiminimax::Options options;
+    options.table = &table;
+    Expectiminimax search(pipEvaluator, options);
+    MoveFilterOptions filters;
+    if (state.range(0) == 0) {
+        filters.stages = {{2, 1, 0.0f}};
+    }
+    const Board board(RACE); // Race 6-2, 12 plays
+    MoveAnalysis analysis;
+    for (auto _ : state) {
+        table.clear();
+        analysis = analyzePlays(board, search, filters);
+        benchmark::DoNotOptimize(analysis.best());
+    }
+    for (const FilterStageReport& stage : analysis.stages) {
+        state.counters["ms" + std::to_string(stage.depth)] = stage.seconds * 1000.0;
+        state.counters["plays" + std::to_string(stage.depth)] = (double)stage.scored;
+    }
+}
+BENCHMARK(BM_MoveFilter)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MoveFilter)->Arg(0)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+struct BenchNode {
+    Board board;
+    uint32_t visits;
+    uint32_t firstEdge;
+};
+
+// Allocating a tree's worth of nodes and freeing them: one arena reset
+static void BM_ArenaNodes(benchmark::State& state) {
+    NodeArena<BenchNode, 12> arena;
+    const Board board;
+    for (auto _ : state) {
+        arena.reset();
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            const uint32_t index = arena.allocate();
+            arena[index].board = board;
+            arena[index].visits = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArenaNodes)->Arg(100000);
+
+// The same with one heap allocation per node
+static void BM_HeapNodes(benchmark::State& state) {
+    std::vector<BenchNode*> nodes(state.range(0));
+    const Board board;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            nodes[i] = new BenchNode{board, 0, 0};
+        }
+        benchmark::ClobberMemory();
+        for (BenchNode* node : nodes) {
+            delete node;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeapNodes)->Arg(100000);
+
+// Transposition table probes, and a store on every miss, over the keys of random games (2^20
+// positions, cycled through) from several threads sharing one table
+static void BM_TranspositionTable(benchmark::State& state) {
+    static const uint32_t KEYS = 1u << 20;
+    static TranspositionTable table(64);
+    static std::vector<uint64_t> keys;
+    if (state.thread_index() == 0) {
+        table.clear();
+        keys.clear();
+        Rng rng(9);
+        std::vector<Play> plays;
+        Board board;
+        while (keys.size() < KEYS) {
+            if (board.isGameOver()) {
+                board = Board(rng);
+            }
+            keys.push_back(board.getKey());
+            board.legalPlays(plays);
+            board.applyPlay(plays[rng.below((uint32_t)plays.size())], rng);
+        }
+    }
+    uint32_t i = (uint32_t)state.thread_index() * (KEYS / 8);
+    TranspositionTable::Entry entry;
+    for (auto _ : state) {
+        const uint64_t key = keys[i++ & (KEYS - 1)];
+        if (!table.probe(key, entry)) {
+            table.store(key, TranspositionTable::Entry{0.0f, 1, TranspositionTable::Bound::EXACT, 0});
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        state.counters["hitRate"] = table.hitRate();
+        state.counters["collisions"] = (double)table.collisions();
+    }
+}
+BENCHMARK(BM_TranspositionTable)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "../logic/BearoffDatabase.h"
+#include "../logic/TwoSidedBearoff.h"
+
+// Usage: MakeBearoff [-2] <file> [checkers]
+// Generates the one-sided bear-off database for up to <checkers> checkers (15 by default), or with -2
+// the two-sided database for up to <checkers> checkers per side (6 by default), and prints a lookup
+// from the written file.
+int main(int argc, char **argv) {
+    const bool twoSided = argc > 1 && std::strcmp(argv[1], "-2") == 0;
+    if (twoSided) {
+        --argc;
+        ++argv;
+    }
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " [-2] <file> [checkers]" << std::endl;
+        return 1;
+    }
+    const int checkers = (argc == 3) ? std::atoi(argv[2])
+                                     : (twoSided ? TwoSidedBearoff::DEFAULT_CHECKERS : BearoffDatabase::MAX_CHECKERS);
+
+    auto start = std::chrono::steady_clock::now();
+    const bool written = twoSided ? TwoSidedBearoff::generate(argv[1], checkers) : BearoffDatabase::generate(argv[1], checkers);
+    if (!written) {
+        std::cerr << "Could not write " << argv[1] << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const uint8_t allOnSix[BearoffDatabase::POINTS] = {0, 0, 0, 0, 0, (uint8_t)checkers};
+    const uint32_t index = BearoffDatabase::index(allOnSix);
+    if (twoSided) {
+        TwoSidedBearoff db;
+        if (!db.open(argv[1])) {
+            std::cerr << "Could not read back " << argv[1] << std::endl;
+            return 1;
+        }
+        std::cout << db.size() << " x " << db.size() << " positions in " << seconds << " seconds" << std::endl;
+        std::cout << "Chance of the side on roll with every checker on the 6-point on both sides: "
+                  << db.winProbability(index, index) << std::endl;
+    } else {
+        BearoffDatabase db;
+        if (!db.open(argv[1])) {
+            std::cerr << "Could not read back " << argv[1] << std::endl;
+            return 1;
+        }
+        std::cout << db.size() << " positions in " << seconds << " seconds" << std::endl;
+        std::cout << "Expected rolls with every checker on the 6-point: " << db.meanRolls(index) << std::endl;
+    }
+    return 0;
+}
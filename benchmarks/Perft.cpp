@@ -0,0 +1,36 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "../logic/Board.h"
+#include "../logic/Perft.h"
+
+// Usage: Perft <depth> [31 integers in the Board array constructor format]
+// Runs perft for every depth from 1 to <depth> from the given position (the opening by default,
+// player 1 to move) and prints the counts and the search throughput.
+int main(int argc, char **argv) {
+    if (argc != 2 && argc != 33) {
+        std::cerr << "Usage: " << argv[0] << " <depth> [31 board integers]" << std::endl;
+        return 1;
+    }
+    const int depth = std::atoi(argv[1]);
+
+    int state[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                     -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                     0, 0, -1, -1, -1, -1, 1};
+    if (argc == 33) {
+        for (int i = 0; i < 31; ++i) {
+            state[i] = std::atoi(argv[i + 2]);
+        }
+    }
+    Board board(state);
+
+    std::cout << "depth\tleaves\tunique\tturns\tnodes\tseconds\tnodes/sec" << std::endl;
+    for (int d = 1; d <= depth; ++d) {
+        auto start = std::chrono::steady_clock::now();
+        PerftResult r = perft(board, d);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << d << "\t" << r.leaves << "\t" << r.uniquePositions << "\t" << r.turns << "\t"
+                  << r.nodes << "\t" << seconds << "\t" << (seconds > 0 ? r.nodes / seconds : 0.0) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/BearoffDatabase.h"
+
+namespace {
+
+// A small database shared by the tests, written once to a temporary file
+class BearoffDatabaseTest : public testing::Test {
+    protected:
+        static constexpr int CHECKERS = 4;
+        static std::string path;
+
+        static void SetUpTestSuite() {
+            path = testing::TempDir() + "bearoff_test.db";
+            ASSERT_TRUE(BearoffDatabase::generate(path, CHECKERS));
+        }
+
+        static void TearDownTestSuite() {
+            std::remove(path.c_str());
+        }
+
+        static uint32_t indexOf(std::initializer_list<uint8_t> counts) {
+            uint8_t c[BearoffDatabase::POINTS] = {};
+            int i = 0;
+            for (uint8_t n : counts) {
+                c[i++] = n;
+            }
+            return BearoffDatabase::index(c);
+        }
+};
+
+std::string BearoffDatabaseTest::path;
+
+} // namespace
+
+TEST_F(BearoffDatabaseTest, IndexIsABijection) {
+    // Every position of up to 4 checkers gets a distinct index below C(10, 6)
+    std::vector<bool> seen(BearoffDatabase::positionCount(CHECKERS), false);
+    uint8_t c[BearoffDatabase::POINTS];
+    for (int code = 0; code < 5 * 5 * 5 * 5 * 5 * 5; ++code) {
+        int total = 0;
+        for (int i = 0, rest = code; i < BearoffDatabase::POINTS; ++i, rest /= 5) {
+            c[i] = (uint8_t)(rest % 5);
+            total += c[i];
+        }
+        if (total > CHECKERS) {
+            continue;
+        }
+        const uint32_t index = BearoffDatabase::index(c);
+        ASSERT_LT(index, seen.size());
+        EXPECT_FALSE(seen[index]);
+        seen[index] = true;
+
+        uint8_t unranked[BearoffDatabase::POINTS];
+        BearoffDatabase::counts(index, unranked);
+        EXPECT_TRUE(std::equal(c, c + BearoffDatabase::POINTS, unranked)) << "Index " << index;
+    }
+    EXPECT_EQ(seen.size(), 210u);
+    EXPECT_EQ(BearoffDatabase::positionCount(BearoffDatabase::MAX_CHECKERS), 54264u);
+}
+
+TEST_F(BearoffDatabaseTest, KnownDistributions) {
+    BearoffDatabase db;
+    ASSERT_TRUE(db.open(path));
+    EXPECT_EQ(db.checkers(), CHECKERS);
+    EXPECT_EQ(db.size(), 210u);
+
+    EXPECT_DOUBLE_EQ(db.meanRolls(indexOf({})), 0.0);
+    EXPECT_DOUBLE_EQ(db.probability(indexOf({}), 0), 1.0);
+
+    // A checker on the 1-point or the 2-point is off with any roll
+    EXPECT_DOUBLE_EQ(db.probability(indexOf({1}), 1), 1.0);
+    EXPECT_DOUBLE_EQ(db.probability(indexOf({0, 1}), 1), 1.0);
+
+    // A checker on the 6-point stays on with 1-1, 2-1, 3-1, 4-1 and 3-2 (9 rolls out of 36)
+    const uint32_t six = indexOf({0, 0, 0, 0, 0, 1});
+    EXPECT_NEAR(db.probability(six, 1), 27.0 / 36.0, 1e-4);
+    EXPECT_NEAR(db.probability(six, 2), 9.0 / 36.0, 1e-4);
+    EXPECT_NEAR(db.meanRolls(six), 1.25, 1e-6);
+
+    // Three checkers on the 1-point need a double to go off in one roll
+    EXPECT_NEAR(db.probability(indexOf({3}), 1), 6.0 / 36.0, 1e-4);
+    EXPECT_NEAR(db.probabilityWithin(indexOf({3}), 2), 1.0, 1e-4);
+}
+
+TEST_F(BearoffDatabaseTest, DistributionsAreConsistent) {
+    BearoffDatabase db;
+    ASSERT_TRUE(db.open(path));
+    for (uint32_t i = 0; i < db.size(); ++i) {
+        EXPECT_NEAR(db.probabilityWithin(i, 255), 1.0, 1e-3) << "Index " << i;
+        double mean = 0.0;
+        for (int n = 0; n < 64; ++n) {
+            mean += n * db.probability(i, n);
+        }
+        EXPECT_NEAR(mean, db.meanRolls(i), 1e-2) << "Index " << i;
+    }
+
+    // Moving a checker further from home never makes the bear-off faster
+    EXPECT_LT(db.meanRolls(indexOf({2, 1})), db.meanRolls(indexOf({1, 2})));
+    EXPECT_LT(db.meanRolls(indexOf({0, 0, 0, 0, 0, 3})), db.meanRolls(indexOf({0, 0, 0, 0, 0, 4})));
+}
+
+TEST_F(BearoffDatabaseTest, LooksUpBoardPositions) {
+    BearoffDatabase db;
+    ASSERT_TRUE(db.open(path));
+
+    // Player 1 has 2 checkers on its 6-point (point 18), player 2 has 1 on its 1-point (point 0)
+    int state[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+                     0, 0, -1, -1, -1, -1, 1};
+    Board board(state);
+    ASSERT_TRUE(db.contains(board.position(), 0));
+    ASSERT_TRUE(db.contains(board.position(), 1));
+    EXPECT_EQ(db.index(board.position(), 0), indexOf({0, 0, 0, 0, 0, 2}));
+    EXPECT_EQ(db.index(board.position(), 1), indexOf({1}));
+
+    // Checkers outside the home board or too many checkers cannot be looked up
+    state[17] = 1;
+    EXPECT_FALSE(db.contains(Board(state).position(), 0));
+    state[17] = 0;
+    state[18] = 5;
+    EXPECT_FALSE(db.contains(Board(state).position(), 0));
+}
+
+TEST_F(BearoffDatabaseTest, RejectsTruncatedFiles) {
+    std::vector<char> bytes;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        bytes.push_back((char)c);
+    }
+    std::fclose(file);
+
+    const std::string truncated = testing::TempDir() + "bearoff_truncated.db";
+    for (size_t cut : {(size_t)2, (size_t)1, bytes.size() / 2}) {
+        file = std::fopen(truncated.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fwrite(bytes.data(), 1, bytes.size() - cut, file);
+        std::fclose(file);
+        BearoffDatabase db;
+        EXPECT_FALSE(db.open(truncated)) << cut << " bytes cut";
+    }
+    std::remove(truncated.c_str());
+}
+
+TEST(BearoffDatabaseFileTest, RejectsMissingAndForeignFiles) {
+    BearoffDatabase db;
+    EXPECT_FALSE(db.open(testing::TempDir() + "no_such_bearoff.db"));
+    const std::string path = testing::TempDir() + "not_bearoff.db";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("this is not a bear-off database", file);
+    std::fclose(file);
+    EXPECT_FALSE(db.open(path));
+    EXPECT_FALSE(db.isOpen());
+    std::remove(path.c_str());
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
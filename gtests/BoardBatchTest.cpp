@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/BoardBatch.h"
+
+TEST(BoardBatchTest, LockstepMatchesIndividualBoards) {
+    // A batch and a set of Boards driven by identically seeded generators must play the same games
+    const size_t GAMES = 64;
+    Rng batchRng(3), boardRng(3), choice(9);
+    BoardBatch batch(GAMES, batchRng);
+    std::vector<Board> boards;
+    for (size_t g = 0; g < GAMES; ++g) {
+        boards.emplace_back(boardRng);
+    }
+
+    std::vector<std::vector<Play>> plays;
+    std::vector<Play> chosen(GAMES);
+    std::vector<int8_t> outcomes;
+    for (int turn = 0; turn < 400; ++turn) {
+        batch.legalPlaysAll(plays);
+        batch.outcomeAll(outcomes);
+        bool allOver = true;
+        for (size_t g = 0; g < GAMES; ++g) {
+            ASSERT_EQ(batch.get(g).position(), boards[g].position()) << "Game " << g << ", turn " << turn;
+            ASSERT_EQ(outcomes[g], boards[g].getOutcome()) << "Game " << g << ", turn " << turn;
+            if (boards[g].isGameOver()) {
+                EXPECT_TRUE(plays[g].empty());
+                continue;
+            }
+            allOver = false;
+            ASSERT_EQ(plays[g], boards[g].legalPlays());
+            chosen[g] = plays[g][choice.below((uint32_t)plays[g].size())];
+        }
+        if (allOver) {
+            break;
+        }
+        batch.applyAll(chosen, batchRng);
+        for (size_t g = 0; g < GAMES; ++g) {
+            if (!boards[g].isGameOver()) {
+                boards[g].applyPlay(chosen[g], boardRng);
+            }
+        }
+    }
+    batch.outcomeAll(outcomes);
+    for (size_t g = 0; g < GAMES; ++g) {
+        EXPECT_NE(outcomes[g], 0) << "Every game should be over after 400 turns";
+    }
+}
+
+TEST(BoardBatchTest, SetAndGetRoundTrip) {
+    int init_board[31] = {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 1,
+                          -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                          2, 1, 3, 3, 3, 3, -1};
+    Board b(init_board);
+    BoardBatch batch(4);
+    batch.set(2, b);
+    EXPECT_EQ(batch.get(2).position(), b.position());
+    EXPECT_EQ(batch.get(2).getKey(), b.getKey());
+
+
+    // Rolls are drawn in game order, like rolling each board in turn
+    std::vector<Board> boards;
+    for (size_t g = 0; g < batch.size(); ++g) {
+        boards.push_back(batch.get(g));
+    }
+    Rng batchRng(1), boardRng(1);
+    batch.rollDiceAll(batchRng);
+    for (size_t g = 0; g < batch.size(); ++g) {
+        boards[g].rollDice(boardRng);
+        EXPECT_EQ(batch.get(g).position(), boards[g].position());
+    }
+}
+
+TEST(BoardBatchTest, OutcomeOfFinishedGames) {
+    int gammon[31] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,       // Player 1 has borne off everything,
+                      -15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,     // player 2 none
+                      0, 0, -1, -1, -1, -1, -1};
+    int backgammon[31] = {15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // Player 2 has borne off everything and
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // player 1 is still in player 2's home
+                          0, 0, -1, -1, -1, -1, 1};
+    BoardBatch batch(3);
+    batch.set(0, Board(gammon));
+    batch.set(1, Board(backgammon));
+    std::vector<int8_t> outcomes;
+    batch.outcomeAll(outcomes);
+    EXPECT_EQ(outcomes[0], Board(gammon).getOutcome());
+    EXPECT_EQ(outcomes[0], 2);
+    EXPECT_EQ(outcomes[1], Board(backgammon).getOutcome());
+    EXPECT_EQ(outcomes[1], -3);
+    EXPECT_EQ(outcomes[2], 0) << "Untouched game is at the opening";
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
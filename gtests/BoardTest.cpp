@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <type_traits>
 #include "../logic/Board.h"
 
 // Test fixture class with privileged access to Board
@@ -38,106 +41,106 @@ protected:
     // Helper methods to manipulate internal board state
     void setDice(int face1, int face2) {
         // Clear existing dice
-        std::fill(std::begin(board.dice), std::end(board.dice), 0);
+        std::fill(std::begin(board.pos.dice), std::end(board.pos.dice), 0);
         
         // Set the specific dice values
-        if (face1 > 0 && face1 <= 6) board.dice[face1-1]++;
-        if (face2 > 0 && face2 <= 6) board.dice[face2-1]++;
+        if (face1 > 0 && face1 <= 6) board.pos.dice[face1-1]++;
+        if (face2 > 0 && face2 <= 6) board.pos.dice[face2-1]++;
     }
 
     void setDiceBar(int face1, int face2) {
         // Clear existing dice for the bar board
-        std::fill(std::begin(barBoard.dice), std::end(barBoard.dice), 0);
+        std::fill(std::begin(barBoard.pos.dice), std::end(barBoard.pos.dice), 0);
         
         // Set the specific dice values for the bar board
-        if (face1 > 0 && face1 <= 6) barBoard.dice[face1-1]++;
-        if (face2 > 0 && face2 <= 6) barBoard.dice[face2-1]++;
+        if (face1 > 0 && face1 <= 6) barBoard.pos.dice[face1-1]++;
+        if (face2 > 0 && face2 <= 6) barBoard.pos.dice[face2-1]++;
     }
 
     void setDiceBarComplex(int face1, int face2) {
         // Clear existing dice for the complex bar board
-        std::fill(std::begin(barBoardComplex.dice), std::end(barBoardComplex.dice), 0);
+        std::fill(std::begin(barBoardComplex.pos.dice), std::end(barBoardComplex.pos.dice), 0);
         
         // Set the specific dice values for the complex bar board
-        if (face1 > 0 && face1 <= 6) barBoardComplex.dice[face1-1]++;
-        if (face2 > 0 && face2 <= 6) barBoardComplex.dice[face2-1]++;
+        if (face1 > 0 && face1 <= 6) barBoardComplex.pos.dice[face1-1]++;
+        if (face2 > 0 && face2 <= 6) barBoardComplex.pos.dice[face2-1]++;
     }
 
     void setDiceBearOff(int face1, int face2) {
         // Clear existing dice for the bearing off board
-        std::fill(std::begin(bearingOffBoard.dice), std::end(bearingOffBoard.dice), 0);
+        std::fill(std::begin(bearingOffBoard.pos.dice), std::end(bearingOffBoard.pos.dice), 0);
         
         // Set the specific dice values for the bearing off board
-        if (face1 > 0 && face1 <= 6) bearingOffBoard.dice[face1-1]++;
-        if (face2 > 0 && face2 <= 6) bearingOffBoard.dice[face2-1]++;
+        if (face1 > 0 && face1 <= 6) bearingOffBoard.pos.dice[face1-1]++;
+        if (face2 > 0 && face2 <= 6) bearingOffBoard.pos.dice[face2-1]++;
     }
 
     void setDiceBearOffComplex(int face1, int face2) {
         // Clear existing dice for the complex bearing off board
-        std::fill(std::begin(bearingOffComplex.dice), std::end(bearingOffComplex.dice), 0);
+        std::fill(std::begin(bearingOffComplex.pos.dice), std::end(bearingOffComplex.pos.dice), 0);
         
         // Set the specific dice values for the complex bearing off board
-        if (face1 > 0 && face1 <= 6) bearingOffComplex.dice[face1-1]++;
-        if (face2 > 0 && face2 <= 6) bearingOffComplex.dice[face2-1]++;
+        if (face1 > 0 && face1 <= 6) bearingOffComplex.pos.dice[face1-1]++;
+        if (face2 > 0 && face2 <= 6) bearingOffComplex.pos.dice[face2-1]++;
     }
     
     void setCurrentPlayer(int player) {
-        board.currentPlayer = player;
+        board.pos.currentPlayer = player;
     }
 
     void setCurrentPlayerBar(int player) {
-        barBoard.currentPlayer = player; // Set the current player for the bar board
+        barBoard.pos.currentPlayer = player; // Set the current player for the bar board
     }
 
     void setCurrentPlayerBarComplex(int player) {
-        barBoardComplex.currentPlayer = player; // Set the current player for the complex bar board
+        barBoardComplex.pos.currentPlayer = player; // Set the current player for the complex bar board
     }
 
     void setCurrentPlayerBearOff(int player) {
-        bearingOffBoard.currentPlayer = player; // Set the current player for the bearing off board
+        bearingOffBoard.pos.currentPlayer = player; // Set the current player for the bearing off board
     }
     
     void setCurrentPlayerBearOffComplex(int player) {
-        bearingOffComplex.currentPlayer = player; // Set the current player for the complex bearing off board
+        bearingOffComplex.pos.currentPlayer = player; // Set the current player for the complex bearing off board
     }
 
     void placePiece(int player, int position, int count) {
         if (player == 1) {
-            board.player1[position] = count;
+            board.pos.setCount(0, position, count);
         } else if (player == -1 || player == 2) {
-            board.player2[position] = count;
+            board.pos.setCount(1, position, count);
         }
     }
     
     void setBar(int player, int count) {
         if (player == 1) {
-            board.bar1 = count;
+            board.pos.bar[0] = count;
         } else if (player == -1 || player == 2) {
-            board.bar2 = count;
+            board.pos.bar[1] = count;
         }
     }
 
     void setBarBar(int player, int count) {
         if (player == 1) {
-            barBoard.bar1 = count; // Set the number of pieces on the bar for player 1 in barBoard
+            barBoard.pos.bar[0] = count; // Set the number of pieces on the bar for player 1 in barBoard
         } else if (player == -1 || player == 2) {
-            barBoard.bar2 = count; // Set the number of pieces on the bar for player 2 in barBoard
+            barBoard.pos.bar[1] = count; // Set the number of pieces on the bar for player 2 in barBoard
         }
     }
 
     void setBarComplex(int player, int count) {
         if (player == 1) {
-            barBoardComplex.bar1 = count; // Set the number of pieces on the bar for player 1 in complex barBoard
+            barBoardComplex.pos.bar[0] = count; // Set the number of pieces on the bar for player 1 in complex barBoard
         } else if (player == -1 || player == 2) {
-            barBoardComplex.bar2 = count; // Set the number of pieces on the bar for player 2 in complex barBoard
+            barBoardComplex.pos.bar[1] = count; // Set the number of pieces on the bar for player 2 in complex barBoard
         }
     }
 
     void setBarBearOffComplex(int player, int count) {
         if (player == 1) {
-            bearingOffComplex.bar1 = count; // Set the number of pieces on the bar for player 1 in complex bearing off board
+            bearingOffComplex.pos.bar[0] = count; // Set the number of pieces on the bar for player 1 in complex bearing off board
         } else if (player == -1 || player == 2) {
-            bearingOffComplex.bar2 = count; // Set the number of pieces on the bar for player 2 in complex bearing off board
+            bearingOffComplex.pos.bar[1] = count; // Set the number of pieces on the bar for player 2 in complex bearing off board
         }
     }
 
@@ -189,16 +192,24 @@ protected:
         return barBoardComplex.getBar2(); // Get the number of pieces on the bar for player 2 in complex barBoard
     }
 
-    uint8_t* getPlayer1Board() {
-        return board.player1; // Get the board state for player 1
+    std::array<uint8_t, 24> getPlayer1Board() {
+        return unpack(0); // Get the board state for player 1
     }
 
-    uint8_t* getPlayer2Board() {
-        return board.player2; // Get the board state for player 2
+    std::array<uint8_t, 24> getPlayer2Board() {
+        return unpack(1); // Get the board state for player 2
     }
 
     uint8_t* getDice() {
-        return board.dice; // Get the dice state
+        return board.pos.dice; // Get the dice state
+    }
+
+    std::array<uint8_t, 24> unpack(int side) const {
+        std::array<uint8_t, 24> counts;
+        for (int i = 0; i < 24; ++i) {
+            counts[i] = board.pos.count(side, i); // Expand the packed nibbles into one count per point
+        }
+        return counts;
     }
 
 };
@@ -833,6 +844,227 @@ TEST(OutcomeTest, TestPlayer1Wins) {
 }
 
 
+TEST(PackedBoardTest, PositionFitsInCacheLine) {
+    EXPECT_TRUE(std::is_trivially_copyable<Board>::value) << "Board should be trivially copyable";
+    EXPECT_LE(sizeof(Board), 64u) << "Board should fit in a single cache line";
+
+    Board b;
+    const Position& pos = b.position();
+    EXPECT_EQ(pos.count(0, 11), 5);
+    EXPECT_EQ(pos.count(1, 12), 5);
+    EXPECT_TRUE(pos.made[0] & (1u << 18)) << "Point 18 should be made for player 1";
+    EXPECT_EQ(pos.checkersOnBoard(0), 15);
+    EXPECT_EQ(pos.checkersOnBoard(1), 15);
+}
+
+TEST(PackedBoardTest, BearOffRemovesChecker) {
+    int init_board[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1,
+                          0, 0, 1, 2, -1, -1, 1};
+    Board b(init_board);
+    b.move(23, 1);
+    EXPECT_EQ(b.position().count(0, 23), 0) << "Checker on point 23 should be borne off";
+    EXPECT_EQ(b.position().count(1, 0), 1) << "Bearing off must not touch the opponent's checkers";
+    EXPECT_EQ(b.position().checkersOnBoard(0), 2);
+    EXPECT_FALSE(b.diceAvailable(1));
+}
+
+TEST(PackedBoardTest, BarEntryUsesDieAndHits) {
+    int init_board[31] = {0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          1, 0, 3, 5, -1, -1, 1};
+    Board b(init_board);
+    b.move(2, 7); // Enter with the 3 on the opponent's blot
+    EXPECT_EQ(b.getBar1(), 0);
+    EXPECT_EQ(b.getBar2(), 1) << "The blot on the entry point should be hit";
+    EXPECT_EQ(b.position().count(0, 2), 1);
+    EXPECT_EQ(b.position().count(1, 2), 0);
+    EXPECT_FALSE(b.diceAvailable(3)) << "Entering on point 2 uses the 3";
+    EXPECT_TRUE(b.diceAvailable(5));
+}
+
+TEST(MakeUnmakeTest, UndoRestoresPosition) {
+    // Play random games and check that every legal single move can be taken back exactly
+    Rng rng(7);
+    int hits = 0, entries = 0, bearOffs = 0;
+    for (int game = 0; game < 20; ++game) {
+        Board b(rng);
+        for (int ply = 0; ply < 1000 && !b.isGameOver(); ++ply) {
+            auto moves = b.validMoves();
+            if (moves.empty()) {
+                b.changePlayer(rng);
+                continue;
+            }
+            Position before = b.position();
+            for (const auto& m : moves) {
+                MoveUndo undo = b.doMove(m.first, m.second);
+                hits += (undo.flags & MoveUndo::HIT) ? 1 : 0;
+                entries += (undo.flags & MoveUndo::FROM_BAR) ? 1 : 0;
+                bearOffs += (b.position().checkersOnBoard(Position::sideIndex(b.getCurrentPlayer())) < before.checkersOnBoard(Position::sideIndex(b.getCurrentPlayer()))) ? 1 : 0;
+                b.undoMove(undo);
+                ASSERT_TRUE(b.position() == before) << "Undo of move " << m.first << ", " << m.second << " did not restore the position";
+                ASSERT_EQ(b.position().occupied[0], before.occupied[0]);
+                ASSERT_EQ(b.position().made[1], before.made[1]);
+            }
+            auto m = moves[rng.below((uint32_t)moves.size())];
+            b.step(m.first, m.second, rng);
+        }
+    }
+    EXPECT_GT(hits, 0) << "Random games should exercise hits";
+    EXPECT_GT(entries, 0) << "Random games should exercise bar entries";
+    EXPECT_GT(bearOffs, 0) << "Random games should exercise bearing off";
+}
+
+TEST_F(BoardFixture, MoveListMatchesVectorApi) {
+    setCurrentPlayer(1);
+    setDice(3, 3);
+    MoveList list;
+    board.validMovesPlayer1(list);
+    auto vec = board.validMovesPlayer1();
+    ASSERT_EQ((size_t)list.size(), vec.size());
+    for (int i = 0; i < list.size(); ++i) {
+        EXPECT_EQ(list[i].from, vec[i].first);
+        EXPECT_EQ(list[i].distance, vec[i].second);
+        EXPECT_EQ(list[i].die(), 3);
+    }
+
+    board.validMoves(list);
+    EXPECT_EQ(list.toVector(), board.validMoves());
+    EXPECT_LE(sizeof(MoveList), 512u) << "MoveList should stay cheap to keep on the stack";
+}
+
+TEST(ZobristTest, IncrementalKeyMatchesFullRecompute) {
+    Rng rng(11);
+    for (int game = 0; game < 20; ++game) {
+        Board b(rng);
+        ASSERT_EQ(b.getKey(), b.position().computeKey());
+        for (int ply = 0; ply < 1000 && !b.isGameOver(); ++ply) {
+            auto moves = b.validMoves();
+            if (moves.empty()) {
+                b.changePlayer(rng);
+                ASSERT_EQ(b.getKey(), b.position().computeKey());
+                continue;
+            }
+            uint64_t before = b.getKey();
+            MoveUndo undo = b.doMove(moves[0].first, moves[0].second);
+            ASSERT_EQ(b.getKey(), b.position().computeKey());
+            b.undoMove(undo);
+            ASSERT_EQ(b.getKey(), before);
+            auto m = moves[rng.below((uint32_t)moves.size())];
+            b.step(m.first, m.second, rng);
+            ASSERT_EQ(b.getKey(), b.position().computeKey()) << "Key drifted at ply " << ply;
+        }
+    }
+}
+
+TEST(ZobristTest, TranspositionsShareKey) {
+    int init_board[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                          -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                          0, 0, 3, 1, -1, -1, 1};
+    Board a(init_board);
+    Board b(init_board);
+    a.move(16, 3);
+    a.move(18, 1);
+    b.move(18, 1);
+    b.move(16, 3);
+    EXPECT_EQ(a.getKey(), b.getKey());
+
+    Board c(init_board);
+    c.move(16, 1);
+    c.move(18, 3);
+    EXPECT_NE(a.getKey(), c.getKey()) << "Different plays should have different keys";
+
+    init_board[30] = -1;
+    Board d(init_board);
+    init_board[30] = 1;
+    EXPECT_EQ(d.getKey() ^ Board(init_board).getKey(), ZOBRIST.player2ToMove) << "Side to move is part of the key";
+}
+
+
+TEST(SideTest, MirroredPositionsGenerateMirroredMoves) {
+    // Both players share one move generator, so swapping the players and flipping the
+    // board must flip every generated move
+    Rng rng(7);
+    for (int game = 0; game < 20; ++game) {
+        Board b(rng);
+        for (int ply = 0; ply < 400 && !b.isGameOver(); ++ply) {
+            const Position& p = b.position();
+            int mirror[31];
+            for (int i = 0; i < 24; ++i) {
+                mirror[23 - i] = p.count(1, i) - p.count(0, i);
+            }
+            mirror[24] = p.bar[1];
+            mirror[25] = p.bar[0];
+            int die = 26;
+            for (int face = 1; face <= 6; ++face) {
+                for (int n = 0; n < p.dice[face - 1]; ++n) {
+                    mirror[die++] = face;
+                }
+            }
+            while (die < 30) {
+                mirror[die++] = -1;
+            }
+            mirror[30] = -p.currentPlayer;
+            Board m(mirror);
+
+            MoveList moves, mirrored;
+            b.validMoves(moves);
+            m.validMoves(mirrored);
+            ASSERT_EQ(moves.size(), mirrored.size()) << "Ply " << ply;
+            for (int i = 0; i < moves.size(); ++i) {
+                Move expected{(int8_t)(23 - moves[i].from), (int8_t)(moves[i].distance == 7 ? 7 : -moves[i].distance)};
+                EXPECT_NE(std::find(mirrored.begin(), mirrored.end(), expected), mirrored.end()) << "Ply " << ply;
+            }
+
+            if (moves.empty()) {
+                b.changePlayer(rng); // No legal move, the turn passes
+            } else {
+                const Move& step = moves[rng.below((uint32_t)moves.size())];
+                b.step(step.from, step.distance, rng);
+            }
+        }
+    }
+}
+
+TEST(SummaryTest, IncrementalSummariesMatchFullRecompute) {
+    Rng rng(21);
+    for (int game = 0; game < 20; ++game) {
+        Board b(rng);
+        EXPECT_EQ(b.pipCount(1), 167);
+        EXPECT_EQ(b.pipCount(-1), 167);
+        EXPECT_FALSE(b.isRace());
+        for (int ply = 0; ply < 600 && !b.isGameOver(); ++ply) {
+            Position full = b.position();
+            full.refresh();
+            for (int player : {1, -1}) {
+                const int side = Position::sideIndex(player);
+                ASSERT_EQ(b.pipCount(player), full.pips[side]) << "Ply " << ply;
+                ASSERT_EQ(b.checkersOff(player), 15 - full.inPlay[side]) << "Ply " << ply;
+                // Rearmost checker by scanning from the far end
+                int highest = b.position().bar[side] > 0 ? 25 : 0;
+                for (int point = 0; point < 24 && highest == 0; ++point) {
+                    int p = (side == 0) ? point : 23 - point;
+                    if (b.position().count(side, p) > 0) {
+                        highest = Position::pipDistance(side, p);
+                    }
+                }
+                ASSERT_EQ(b.highestPoint(player), highest) << "Ply " << ply;
+            }
+            // Race once the rearmost checkers have passed each other
+            ASSERT_EQ(b.isRace(), b.highestPoint(1) + b.highestPoint(-1) <= 25) << "Ply " << ply;
+
+            MoveList moves;
+            b.validMoves(moves);
+            if (moves.empty()) {
+                b.changePlayer(rng);
+            } else {
+                const Move& m = moves[rng.below((uint32_t)moves.size())];
+                b.step(m.from, m.distance, rng);
+            }
+        }
+        EXPECT_EQ(b.checkersOff(b.getOutcome() > 0 ? 1 : -1), 15);
+    }
+}
 
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
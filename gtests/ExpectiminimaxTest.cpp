@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/Expectiminimax.h"
+#include "../logic/TranspositionTable.h"
+#include "SearchTestPositions.h"
+
+namespace {
+
+// Plain expectiminimax without pruning, to check the pruned search against
+float bruteChance(const Board& board, int depth);
+
+float brutePlay(const Board& board, const Play& play, int depth) {
+    const Board after = Expectiminimax::afterPlay(board, play);
+    if (after.isGameOver()) {
+        return (float)(after.getOutcome() * board.getCurrentPlayer());
+    }
+    return -bruteChance(after, depth);
+}
+
+float bruteChance(const Board& board, int depth) {
+    if (depth == 0) {
+        return pipEvaluator(board);
+    }
+    float sum = 0.0f;
+    for (int high = 1; high <= 6; ++high) {
+        for (int low = 1; low <= high; ++low) {
+            Board rolled(board);
+            rolled.setDice(high, low);
+            float best = -1e9f;
+            for (const Play& play : rolled.legalPlays()) {
+                best = std::max(best, brutePlay(rolled, play, depth - 1));
+            }
+            sum += best * (high == low ? 1.0f : 2.0f) / 36.0f;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(ExpectiminimaxTest, OnePlyMatchesPlainExpectiminimax) {
+    Board board(RACE);
+    Expectiminimax search(pipEvaluator);
+    for (const Play& play : board.legalPlays()) {
+        EXPECT_NEAR(search.evaluatePlay(board, play, 1), brutePlay(board, play, 1), 1e-4);
+    }
+
+    Play best;
+    float bestValue = -1e9f;
+    for (const Play& play : board.legalPlays()) {
+        bestValue = std::max(bestValue, brutePlay(board, play, 1));
+    }
+    EXPECT_NEAR(search.search(board, 1, best), bestValue, 1e-4);
+    EXPECT_NEAR(brutePlay(board, best, 1), bestValue, 1e-4);
+}
+
+TEST(ExpectiminimaxTest, PruningKeepsTheTwoPlyValue) {
+    Board board(RACE);
+    float expected = -1e9f;
+    for (const Play& play : board.legalPlays()) {
+        expected = std::max(expected, brutePlay(board, play, 2));
+    }
+
+    Expectiminimax::Options options;
+    options.minEquity = -1.0f; // Equities are in [-1, 1]: no gammons are possible any more
+    options.maxEquity = 1.0f;
+    options.star2 = false;
+    Expectiminimax star1(pipEvaluator, options);
+    options.star2 = true;
+    options.ordering = Expectiminimax::staticOrdering(pipEvaluator);
+    Expectiminimax star2(pipEvaluator, options);
+
+    Play best1, best2;
+    EXPECT_NEAR(star1.search(board, 2, best1), expected, 1e-4);
+    EXPECT_NEAR(star2.search(board, 2, best2), expected, 1e-4);
+    EXPECT_GT(star1.stats().star1Cutoffs, 0u);
+    EXPECT_GT(star2.stats().star2Cutoffs, 0u);
+    EXPECT_LT(star2.stats().evaluations, star1.stats().evaluations);
+}
+
+TEST(ExpectiminimaxTest, TableAnswersRepeatedSearches) {
+    Board board(RACE);
+    TranspositionTable table(1);
+    Expectiminimax::Options options;
+    options.table = &table;
+    Expectiminimax search(pipEvaluator, options);
+    Play first, second;
+    const float value = search.search(board, 1, first);
+    const uint64_t evaluations = search.stats().evaluations;
+    EXPECT_GT(search.stats().tableHits, 0u); // Plays reaching the same position are evaluated once
+
+    EXPECT_FLOAT_EQ(search.search(board, 1, second), value);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(search.stats().evaluations, evaluations);
+}
+
+TEST(ExpectiminimaxTest, FinishedGamesAreScoredExactly) {
+    // Player 1 bears off both checkers with 6-3 and wins; anything else lets player 2 win
+    int state[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0,
+                     0, 0, 6, 3, -1, -1, 1};
+    Board board(state);
+    Expectiminimax search([](const Board&) { return 0.0f; });
+    Play best;
+    EXPECT_FLOAT_EQ(search.search(board, 0, best), 1.0f);
+    EXPECT_TRUE(Expectiminimax::afterPlay(board, best).isGameOver());
+    EXPECT_FLOAT_EQ(search.evaluatePosition(Expectiminimax::afterPlay(board, best), 2), -1.0f);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/Mcts.h"
+
+namespace {
+
+// Uniform priors and a neutral value, so only exact game results move the search
+float neutralEvaluator(const Board&, const std::vector<Play>& plays, float* priors, Rng&) {
+    for (size_t i = 0; i < plays.size(); ++i) {
+        priors[i] = 1.0f;
+    }
+    return 0.0f;
+}
+
+} // namespace
+
+TEST(MctsTest, FindsTheWinningPlay) {
+    // Player 1 has checkers on its 6-point and 2-point and rolls 6-3: bearing both off wins, while
+    // 18-21 then 21 off leaves a checker for player 2, who then bears off its last checker
+    int state[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0,
+                     0, 0, 6, 3, -1, -1, 1};
+    Board board(state);
+    Mcts mcts(neutralEvaluator);
+    mcts.search(board);
+    ASSERT_GE(mcts.rootPlays().size(), 2u);
+
+    Board played(board);
+    played.applyPlay(mcts.bestPlay());
+    EXPECT_TRUE(played.isGameOver());
+    EXPECT_GT(mcts.rootValue(), 0.9);
+}
+
+TEST(MctsTest, PolicyFollowsVisits) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 3, 1, -1, -1, 1};
+    Mcts::Options options;
+    options.iterations = 100;
+    Mcts mcts(randomRolloutEvaluator, options);
+    mcts.search(Board(opening));
+    EXPECT_EQ(mcts.rootPlays().size(), Board(opening).legalPlays().size());
+
+    std::vector<float> policy;
+    mcts.policy(policy);
+    ASSERT_EQ(policy.size(), mcts.rootPlays().size());
+    uint32_t visits = 0;
+    float total = 0.0f;
+    size_t best = 0;
+    for (size_t i = 0; i < policy.size(); ++i) {
+        visits += mcts.rootVisits(i);
+        total += policy[i];
+        if (mcts.rootVisits(i) > mcts.rootVisits(best)) {
+            best = i;
+        }
+    }
+    EXPECT_EQ(visits, 100u);
+    EXPECT_NEAR(total, 1.0f, 1e-5);
+    EXPECT_EQ(mcts.bestPlay(), mcts.rootPlays()[best]);
+    EXPECT_GT(mcts.nodeCount(), 100u);
+}
+
+TEST(MctsTest, ChanceNodesWeightTheRolls) {
+    // Player 1 cannot bear off its checker on the 6-point with 2-1, then player 2 bears off its
+    // checker on its 6-point with 27 rolls out of 36 and loses otherwise: the root is worth -0.5.
+    // The first visit of each decision node scores the neutral 0, a bias that fades with the visits.
+    int state[31] = {0, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+                     0, 0, 2, 1, -1, -1, 1};
+    Mcts::Options options;
+    options.iterations = 20000;
+    Mcts mcts(neutralEvaluator, options);
+    mcts.search(Board(state));
+    EXPECT_NEAR(mcts.rootValue(), -0.5, 0.01);
+}
+
+TEST(MctsTest, SameSeedSameSearch) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 3, 1, -1, -1, 1};
+    Mcts::Options options;
+    options.iterations = 60;
+    options.seed = 5;
+    Mcts a(randomRolloutEvaluator, options);
+    Mcts b(randomRolloutEvaluator, options);
+    a.search(Board(opening));
+    b.search(Board(opening));
+    for (size_t i = 0; i < a.rootPlays().size(); ++i) {
+        EXPECT_EQ(a.rootVisits(i), b.rootVisits(i));
+    }
+    EXPECT_DOUBLE_EQ(a.rootValue(), b.rootValue());
+}
+
+TEST(MctsTest, TreeParallelSharesOneTree) {
+    int state[31] = {0, 0, 0, 0, 0, -1, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+                     0, 0, 2, 1, -1, -1, 1};
+    Mcts::Options options;
+    options.iterations = 20000;
+    options.threads = 4;
+    Mcts mcts(neutralEvaluator, options);
+    mcts.search(Board(state));
+    uint32_t visits = 0;
+    for (size_t i = 0; i < mcts.rootPlays().size(); ++i) {
+        visits += mcts.rootVisits(i);
+    }
+    // Every virtual loss is taken back, so the statistics are those of the 20000 simulations
+    EXPECT_EQ(visits, 20000u);
+
+    // A collision backs up the neutral value of a node being expanded instead of a result in [-1, 1],
+    // and the error steers the selections after it: allow up to twice its weight on top of the
+    // sampling error (the search order, hence the visit mix, changes from run to run)
+    const double tolerance = 0.02 + 2.0 * (double)mcts.collisions() / 20000.0;
+    EXPECT_NEAR(mcts.rootValue(), -0.5, tolerance) << mcts.collisions() << " collisions";
+}
+
+TEST(MctsTest, TreeParallelFindsTheWinningPlay) {
+    int state[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0,
+                     0, 0, 6, 3, -1, -1, 1};
+    Board board(state);
+    Mcts::Options options;
+    options.threads = 3;
+    Mcts mcts(neutralEvaluator, options);
+    mcts.search(board);
+
+    Board played(board);
+    played.applyPlay(mcts.bestPlay());
+    EXPECT_TRUE(played.isGameOver());
+}
+
+TEST(MctsTest, RootParallelMergesTheRootPlays) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 3, 1, -1, -1, 1};
+    Mcts::Options options;
+    options.iterations = 61;
+    options.threads = 3;
+    options.parallelism = Mcts::Parallelism::ROOT;
+    Mcts a(randomRolloutEvaluator, options);
+    Mcts b(randomRolloutEvaluator, options);
+    a.search(Board(opening));
+    b.search(Board(opening));
+    uint32_t visits = 0;
+    for (size_t i = 0; i < a.rootPlays().size(); ++i) {
+        visits += a.rootVisits(i);
+        EXPECT_EQ(a.rootVisits(i), b.rootVisits(i));
+    }
+    EXPECT_EQ(visits, 61u);
+    EXPECT_DOUBLE_EQ(a.rootValue(), b.rootValue());
+    EXPECT_EQ(a.collisions(), 0u);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
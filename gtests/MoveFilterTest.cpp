@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../logic/Board.h"
+#include "../logic/Expectiminimax.h"
+#include "../logic/MoveFilter.h"
+#include "SearchTestPositions.h"
+
+TEST(MoveFilterTest, WideFiltersFindTheBestPlay) {
+    Board board(RACE);
+    Expectiminimax search(pipEvaluator);
+    MoveFilterOptions options;
+    options.stages = {{0, 100, 10.0f}, {1, 100, 10.0f}};
+    const MoveAnalysis analysis = analyzePlays(board, search, options);
+
+    Play best;
+    const float value = search.search(board, 1, best);
+    ASSERT_EQ(analysis.plays.size(), board.legalPlays().size());
+    EXPECT_EQ(analysis.best().play, best);
+    EXPECT_NEAR(analysis.best().equity, value, 1e-5);
+    EXPECT_EQ(analysis.best().depth, 1);
+    for (size_t i = 1; i < analysis.plays.size(); ++i) {
+        EXPECT_GE(analysis.plays[i - 1].equity, analysis.plays[i].equity);
+    }
+}
+
+TEST(MoveFilterTest, StagesKeepTheBestPlaysWithinTheWindow) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 6, 4, -1, -1, 1};
+    Board board(opening);
+    Expectiminimax search(pipEvaluator);
+    MoveFilterOptions options;
+    options.stages = {{0, 3, 0.5f}, {1, 1, 0.0f}};
+    const MoveAnalysis analysis = analyzePlays(board, search, options);
+
+    ASSERT_EQ(analysis.stages.size(), 2u);
+    EXPECT_EQ(analysis.stages[0].scored, board.legalPlays().size());
+    EXPECT_LE(analysis.stages[0].kept, 3u);
+    EXPECT_EQ(analysis.stages[1].scored, analysis.stages[0].kept);
+    EXPECT_GT(analysis.stages[1].evaluations, analysis.stages[0].evaluations);
+    EXPECT_GE(analysis.seconds, analysis.stages[0].seconds + analysis.stages[1].seconds);
+
+    // Survivors of the last stage, then the plays dropped at 0-ply, each group best first
+    const size_t survivors = analysis.stages[0].kept;
+    ASSERT_LT(survivors, analysis.plays.size());
+
+    // The 0-ply stage keeps plays within the window of the best, and drops the next one
+    // only because it is outside the window or the limit was reached
+    float best = -1e9f;
+    for (const CandidatePlay& scored : analysis.plays) {
+        best = std::max(best, search.evaluatePlay(board, scored.play, 0));
+    }
+    for (size_t i = 0; i < survivors; ++i) {
+        EXPECT_GE(search.evaluatePlay(board, analysis.plays[i].play, 0), best - 0.5f);
+    }
+    EXPECT_TRUE(survivors == 3 || analysis.plays[survivors].equity < best - 0.5f);
+    for (size_t i = 0; i < analysis.plays.size(); ++i) {
+        EXPECT_EQ(analysis.plays[i].depth, i < survivors ? 1 : 0);
+        if (i > 0 && i != survivors) {
+            EXPECT_GE(analysis.plays[i - 1].equity, analysis.plays[i].equity);
+        }
+        if (i >= survivors) {
+            EXPECT_FLOAT_EQ(analysis.plays[i].equity, search.evaluatePlay(board, analysis.plays[i].play, 0));
+        }
+    }
+}
+
+TEST(MoveFilterTest, EveryStageKeepsTheBestPlay) {
+    Board board(RACE);
+    Expectiminimax search(pipEvaluator);
+    MoveFilterOptions options;
+    options.stages = {{0, 0, 10.0f}, {1, 1, 0.0f}};
+    const MoveAnalysis analysis = analyzePlays(board, search, options);
+    ASSERT_GT(board.legalPlays().size(), 1u);
+    ASSERT_EQ(analysis.stages.size(), 1u) << "A single play is left after the first stage";
+    EXPECT_EQ(analysis.stages[0].kept, 1u);
+    EXPECT_EQ(analysis.best().depth, 0);
+}
+
+TEST(MoveFilterTest, StopsWhenOnePlayIsLeft) {
+    // A single legal play: 6-5 with every checker on the 1-point bears off two checkers
+    int state[31] = {0, 0, 0, 0, 0, -3, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3,
+                     0, 0, 6, 5, -1, -1, 1};
+    Board board(state);
+    Expectiminimax search(pipEvaluator);
+    const MoveAnalysis analysis = analyzePlays(board, search);
+    ASSERT_EQ(analysis.plays.size(), 1u);
+    EXPECT_EQ(analysis.stages.size(), 1u);
+    EXPECT_EQ(analysis.best().depth, 0);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../logic/NeuralNet.h"
+#include "../logic/Rng.h"
+
+namespace {
+
+float logistic(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+// Sparse inputs in [0, 2], like the TD-Gammon encoding where most units are zero
+std::vector<float> randomInputs(Rng& rng, int inputs, size_t rows) {
+    std::vector<float> values((size_t)inputs * rows, 0.0f);
+    for (float& value : values) {
+        if (rng.below(5) == 0) {
+            value = (float)(rng.uniform() * 2.0);
+        }
+    }
+    return values;
+}
+
+NeuralNet tdGammonNet(Rng& rng, const std::vector<int>& hidden) {
+    std::vector<int> sizes = {NeuralNet::TD_GAMMON_INPUTS};
+    sizes.insert(sizes.end(), hidden.begin(), hidden.end());
+    sizes.push_back(NeuralNet::MAX_OUTPUTS);
+    NeuralNet net;
+    EXPECT_TRUE(net.create(sizes));
+    net.randomize(rng, 0.5f);
+    return net;
+}
+
+} // namespace
+
+TEST(NeuralNetTest, MatchesAHandComputedNetwork) {
+    NeuralNet net;
+    ASSERT_TRUE(net.create({3, 2, 1}));
+    net.setWeight(0, 0, 0, 1.0f);
+    net.setWeight(0, 1, 0, -2.0f);
+    net.setWeight(0, 2, 1, 0.5f);
+    net.setBias(0, 0, 0.25f);
+    net.setBias(0, 1, -1.0f);
+    net.setWeight(1, 0, 0, 3.0f);
+    net.setWeight(1, 1, 0, -1.5f);
+    net.setBias(1, 0, 0.1f);
+
+    const float input[3] = {0.5f, 1.0f, 2.0f};
+    const float hidden0 = logistic(0.25f + 0.5f - 2.0f);
+    const float hidden1 = logistic(-1.0f + 1.0f);
+    const float expected = logistic(0.1f + 3.0f * hidden0 - 1.5f * hidden1);
+
+    std::vector<NeuralKernels> kernels = {neuralKernelsScalar()};
+#if defined(__x86_64__)
+    kernels.push_back(neuralKernelsSse2());
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.push_back(neuralKernelsAvx2());
+    }
+#endif
+    for (const NeuralKernels& k : kernels) {
+        net.setKernels(k);
+        float output = 0.0f;
+        net.evaluate(input, &output);
+        EXPECT_NEAR(output, expected, 1e-6) << k.name;
+    }
+}
+
+TEST(NeuralNetTest, VectorKernelsMatchScalar) {
+    Rng rng(11);
+    const size_t rows = 64;
+    for (const std::vector<int>& hidden : {std::vector<int>{80}, std::vector<int>{40, 20}, std::vector<int>{128, 64}}) {
+        NeuralNet net = tdGammonNet(rng, hidden);
+        const std::vector<float> inputs = randomInputs(rng, net.inputs(), rows);
+        std::vector<float> expected(rows * net.outputs());
+        net.setKernels(neuralKernelsScalar());
+        net.evaluate(inputs.data(), rows, expected.data());
+
+        std::vector<NeuralKernels> kernels;
+#if defined(__x86_64__)
+        kernels.push_back(neuralKernelsSse2());
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            kernels.push_back(neuralKernelsAvx2());
+        }
+#endif
+        kernels.push_back(neuralKernels());
+        for (const NeuralKernels& k : kernels) {
+            std::vector<float> outputs(rows * net.outputs());
+            net.setKernels(k);
+            net.evaluate(inputs.data(), rows, outputs.data());
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                EXPECT_NEAR(outputs[i], expected[i], 1e-5) << k.name << " output " << i;
+            }
+        }
+    }
+}
+
+TEST(NeuralNetTest, SigmoidsSaturateWithoutOverflow) {
+    std::vector<NeuralKernels> kernels = {neuralKernelsScalar(), neuralKernels()};
+    for (const NeuralKernels& k : kernels) {
+        float values[8] = {-1000.0f, -90.0f, -20.0f, -1.0f, 0.0f, 1.0f, 20.0f, 1000.0f};
+        k.sigmoid(values, 8);
+        EXPECT_NEAR(values[0], 0.0f, 1e-30) << k.name;
+        EXPECT_NEAR(values[3], logistic(-1.0f), 1e-6) << k.name;
+        EXPECT_FLOAT_EQ(values[4], 0.5f) << k.name;
+        EXPECT_NEAR(values[5], logistic(1.0f), 1e-6) << k.name;
+        EXPECT_FLOAT_EQ(values[7], 1.0f) << k.name;
+        for (float value : values) {
+            EXPECT_TRUE(value >= 0.0f && value <= 1.0f) << k.name;
+        }
+    }
+}
+
+TEST(NeuralNetTest, SavesAndLoadsWeightFiles) {
+    Rng rng(5);
+    NeuralNet net = tdGammonNet(rng, {40, 24});
+    const std::string path = testing::TempDir() + "neuralnet_test.bin";
+    ASSERT_TRUE(net.save(path));
+
+    NeuralNet loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.layerSizes(), net.layerSizes());
+    EXPECT_FLOAT_EQ(loaded.weight(0, 197, 39), net.weight(0, 197, 39));
+    EXPECT_FLOAT_EQ(loaded.bias(2, 4), net.bias(2, 4));
+
+    const std::vector<float> inputs = randomInputs(rng, net.inputs(), 8);
+    std::vector<float> expected(8 * net.outputs()), outputs(8 * net.outputs());
+    net.evaluate(inputs.data(), 8, expected.data());
+    loaded.evaluate(inputs.data(), 8, outputs.data());
+    EXPECT_EQ(outputs, expected);
+
+    // The batch evaluates each row like a single evaluation
+    float single[NeuralNet::MAX_OUTPUTS];
+    loaded.evaluate(inputs.data() + 3 * net.inputs(), single);
+    for (int o = 0; o < net.outputs(); ++o) {
+        EXPECT_EQ(single[o], outputs[3 * net.outputs() + o]);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(NeuralNetTest, RejectsBadShapesAndFiles) {
+    NeuralNet net;
+    EXPECT_FALSE(net.create({198, 5}));
+    EXPECT_FALSE(net.create({198, 80, 40, 20, 5}));
+    EXPECT_FALSE(net.create({198, 80, 6}));
+    EXPECT_FALSE(net.create({198, 0, 5}));
+    EXPECT_TRUE(net.empty());
+
+    EXPECT_FALSE(net.load(testing::TempDir() + "no_such_net.bin"));
+    const std::string path = testing::TempDir() + "not_a_net.bin";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("this is not a network", file);
+    std::fclose(file);
+    EXPECT_FALSE(net.load(path));
+    EXPECT_TRUE(net.empty());
+
+    // A valid header with the weights cut short
+    Rng rng(3);
+    NeuralNet full = tdGammonNet(rng, {10});
+    ASSERT_TRUE(full.save(path));
+    std::vector<char> bytes;
+    file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        bytes.push_back((char)c);
+    }
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size() - 4, file);
+    std::fclose(file);
+    EXPECT_FALSE(net.load(path));
+    EXPECT_TRUE(net.empty());
+    std::remove(path.c_str());
+}
+
+TEST(NeuralNetTest, EquityCountsGammonsAndBackgammons) {
+    const float outputs[5] = {0.6f, 0.2f, 0.05f, 0.1f, 0.01f};
+    EXPECT_FLOAT_EQ(NeuralNet::equity(outputs, 5), 2.0f * 0.6f - 1.0f + 0.2f - 0.1f + 0.05f - 0.01f);
+    EXPECT_FLOAT_EQ(NeuralNet::equity(outputs, 3), 2.0f * 0.6f - 1.0f + 0.2f + 0.05f);
+    EXPECT_FLOAT_EQ(NeuralNet::equity(outputs, 1), 0.2f);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
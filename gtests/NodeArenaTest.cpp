@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "../logic/NodeArena.h"
+
+namespace {
+
+struct TestNode {
+    uint32_t value;
+    uint32_t owner;
+};
+
+} // namespace
+
+TEST(NodeArenaTest, RangesAreContiguousAndStayInASlab) {
+    NodeArena<TestNode, 4> arena; // 16 nodes per slab
+    const uint32_t a = arena.allocate(10);
+    const uint32_t b = arena.allocate(4);
+    EXPECT_EQ(a, 0u);
+    EXPECT_EQ(b, 10u);
+
+    // 5 more do not fit in the 2 left, so the range starts the next slab
+    const uint32_t c = arena.allocate(5);
+    EXPECT_EQ(c, 16u);
+    EXPECT_EQ(arena.size(), 19u);
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        arena[c + i].value = i;
+    }
+    for (uint32_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(arena[c + i].value, i);
+        EXPECT_EQ(&arena[c + i], &arena[c] + i) << "A range is contiguous in memory";
+    }
+}
+
+TEST(NodeArenaTest, ResetKeepsTheMemory) {
+    NodeArena<TestNode, 4> arena;
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate(16);
+    }
+    const size_t bytes = arena.memoryBytes();
+    TestNode* first = &arena[0];
+    EXPECT_EQ(bytes, 10 * 16 * sizeof(TestNode));
+
+    arena.reset();
+    EXPECT_EQ(arena.size(), 0u);
+    EXPECT_EQ(arena.allocate(3), 0u) << "Allocation starts over";
+    EXPECT_EQ(&arena[0], first) << "The first slab is reused";
+    for (int i = 0; i < 9; ++i) {
+        arena.allocate(16);
+    }
+    EXPECT_EQ(arena.memoryBytes(), bytes) << "No slab is allocated again";
+}
+
+TEST(NodeArenaTest, FullArenaReturnsNone) {
+    NodeArena<TestNode, 4> arena(2);
+    EXPECT_NE(arena.allocate(16), (NodeArena<TestNode, 4>::NONE));
+    EXPECT_NE(arena.allocate(16), (NodeArena<TestNode, 4>::NONE));
+    EXPECT_EQ(arena.allocate(1), (NodeArena<TestNode, 4>::NONE));
+}
+
+TEST(NodeArenaTest, CursorsAllocateDisjointNodes) {
+    typedef NodeArena<TestNode, 8> Arena;
+    Arena arena;
+    const int THREADS = 4;
+    const uint32_t PER_THREAD = 5000;
+    std::vector<std::vector<uint32_t>> indices(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&arena, &indices, t] {
+            Arena::Cursor cursor(arena);
+            for (uint32_t i = 0; i < PER_THREAD; ++i) {
+                const uint32_t index = cursor.allocate(1);
+                arena[index].value = i;
+                arena[index].owner = (uint32_t)t;
+                indices[t].push_back(index);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    std::vector<uint32_t> all;
+    for (int t = 0; t < THREADS; ++t) {
+        for (uint32_t i = 0; i < PER_THREAD; ++i) {
+            ASSERT_EQ(arena[indices[t][i]].owner, (uint32_t)t);
+            ASSERT_EQ(arena[indices[t][i]].value, i);
+        }
+        all.insert(all.end(), indices[t].begin(), indices[t].end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end()) << "No node is handed out twice";
+    EXPECT_EQ(arena.size(), THREADS * PER_THREAD);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/OutcomeKernels.h"
+#include "../logic/Rng.h"
+
+// Random kernel inputs biased towards finished games, so every outcome shows up
+struct KernelInputs {
+    std::vector<uint32_t> occupied[2];
+    std::vector<uint8_t> onBoard[2];
+    std::vector<uint8_t> bar[2];
+
+    KernelInputs(size_t games, Rng& rng) {
+        for (int side = 0; side < 2; ++side) {
+            occupied[side].resize(games);
+            onBoard[side].resize(games);
+            bar[side].resize(games);
+        }
+        for (size_t g = 0; g < games; ++g) {
+            for (int side = 0; side < 2; ++side) {
+                occupied[side][g] = (rng.below(3) == 0) ? 0 : (uint32_t)(rng.next() & 0xFFFFFF) & (rng.below(2) ? 0x3F : 0xFC0000);
+                onBoard[side][g] = (uint8_t)(rng.below(2) ? 15 : rng.below(16));
+                bar[side][g] = (uint8_t)(rng.below(4) == 0 ? rng.below(3) : 0);
+            }
+        }
+    }
+
+    OutcomeInputs view() const {
+        return {{occupied[0].data(), occupied[1].data()},
+                {onBoard[0].data(), onBoard[1].data()},
+                {bar[0].data(), bar[1].data()}};
+    }
+};
+
+TEST(OutcomeKernelsTest, ScalarMatchesBoard) {
+    int backgammon[31] = {15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, -1, -1, -1, -1, 1};
+    int single[31] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -3,
+                      0, 0, -1, -1, -1, -1, 1};
+    for (const int* state : {backgammon, single}) {
+        Board b(state);
+        const Position& p = b.position();
+        uint8_t onBoard[2] = {(uint8_t)p.checkersOnBoard(0), (uint8_t)p.checkersOnBoard(1)};
+        OutcomeInputs in = {{&p.occupied[0], &p.occupied[1]}, {&onBoard[0], &onBoard[1]}, {&p.bar[0], &p.bar[1]}};
+        int8_t outcome;
+        outcomesScalar(in, &outcome, 1);
+        EXPECT_EQ(outcome, b.getOutcome());
+    }
+}
+
+TEST(OutcomeKernelsTest, VectorKernelsMatchScalar) {
+    Rng rng(17);
+    for (size_t games : {0, 1, 3, 4, 7, 8, 9, 31, 1000}) {
+        KernelInputs inputs(games, rng);
+        std::vector<int8_t> expected(games), actual(games);
+        outcomesScalar(inputs.view(), expected.data(), games);
+
+        std::vector<OutcomeKernel> kernels = {outcomeKernel()};
+#if defined(__x86_64__)
+        kernels.push_back(outcomesSse2);
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.push_back(outcomesAvx2);
+        }
+#endif
+        for (OutcomeKernel kernel : kernels) {
+            std::fill(actual.begin(), actual.end(), 99);
+            kernel(inputs.view(), actual.data(), games);
+            EXPECT_EQ(actual, expected) << games << " games";
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/Perft.h"
+
+// Independent oracle: tries every ordering of single die moves without any transposition
+// merging, then applies the turn rules to the complete sequences.
+void enumerateSequences(Board& board, int used, int usedHigh, std::vector<std::pair<Position, int>>& finals) {
+    MoveList moves;
+    (board.getCurrentPlayer() == 1) ? board.validMovesPlayer1(moves) : board.validMovesPlayer2(moves);
+    if (moves.empty()) {
+        finals.emplace_back(board.position(), used * 8 + usedHigh);
+        return;
+    }
+    int high = 0;
+    for (int face = 6; face >= 1 && high == 0; --face) {
+        if (board.position().dice[face - 1] > 0) {
+            high = face;
+        }
+    }
+    for (const Move& m : moves) {
+        MoveUndo undo = board.doMove(m.from, m.distance);
+        enumerateSequences(board, used + 1, usedHigh | (m.die() == high ? 1 : 0), finals);
+        board.undoMove(undo);
+    }
+}
+
+// Distinct complete plays of a roll by brute force (dice excluded from the final positions)
+std::set<uint64_t> bruteForcePlays(const Position& start) {
+    Board board(start);
+    std::vector<std::pair<Position, int>> finals;
+    enumerateSequences(board, 0, 0, finals);
+    int mostUsed = 0;
+    for (const auto& f : finals) {
+        mostUsed = std::max(mostUsed, f.second / 8);
+    }
+    // When only one die of a non-double can be played, the higher one must be played if possible
+    bool highPossible = false;
+    for (const auto& f : finals) {
+        highPossible |= (f.second / 8 == mostUsed && (f.second & 1));
+    }
+    const bool isDouble = [&] {
+        for (int face = 0; face < 6; ++face) {
+            if (start.dice[face] > 1) return true;
+        }
+        return false;
+    }();
+    std::set<uint64_t> plays;
+    for (auto& f : finals) {
+        if (f.second / 8 != mostUsed) continue;
+        if (mostUsed == 1 && !isDouble && highPossible && !(f.second & 1)) continue;
+        for (int face = 1; face <= 6; ++face) {
+            f.first.setDice(face, 0);
+        }
+        plays.insert(f.first.key);
+    }
+    return plays;
+}
+
+// perft to depth 1 is the number of distinct plays summed over the 21 rolls
+uint64_t bruteForceDepth1(const Board& board) {
+    uint64_t total = 0;
+    for (int high = 1; high <= 6; ++high) {
+        for (int low = 1; low <= high; ++low) {
+            Position rolled = board.position();
+            for (int face = 1; face <= 6; ++face) {
+                rolled.setDice(face, 0);
+            }
+            rolled.setDice(high, high == low ? 4 : 1);
+            rolled.setDice(low, high == low ? 4 : 1);
+            total += bruteForcePlays(rolled).size();
+        }
+    }
+    return total;
+}
+
+TEST(PerftTest, DepthZeroIsTheBoard) {
+    Board b;
+    PerftResult r = perft(b, 0);
+    EXPECT_EQ(r.leaves, 1);
+    EXPECT_EQ(r.uniquePositions, 1);
+    EXPECT_EQ(r.turns, 0);
+}
+
+TEST(PerftTest, DepthOneMatchesBruteForce) {
+    int positions[][31] = {
+        {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,  // Opening
+         -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+         0, 0, -1, -1, -1, -1, 1},
+        {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 3, // Contact, player 2 to move
+         -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+         0, 0, -1, -1, -1, -1, -1},
+        {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 1, // Two checkers on the bar
+         -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+         2, 0, -1, -1, -1, -1, 1},
+        {-3, -3, -3, -2, -2, 0, 0, 0, 0, 0, 0, 0, // Bearing off with contact
+         0, 0, 0, 0, 0, 0, 3, -1, 3, 3, 2, 2,
+         0, 0, -1, -1, -1, -1, 1},
+        {0, -10, 0, 0, -1, 0, -1, 0, 0, 0, 0, 0, // A lone checker bearing off: every roll has one play,
+         0, 0, -1, -1, 0, -1, 0, 0, 0, 0, 0, 1,  // the higher-die rule prunes the other die
+         0, 0, -1, -1, -1, -1, 1},
+    };
+    for (auto& state : positions) {
+        Board b(state);
+        PerftResult r = perft(b, 1);
+        EXPECT_EQ(r.turns, 21);
+        EXPECT_EQ(r.leaves, bruteForceDepth1(b));
+        EXPECT_LE(r.uniquePositions, r.leaves);
+    }
+    EXPECT_EQ(perft(Board(positions[4]), 1).leaves, 21);
+}
+
+TEST(PerftTest, OpeningCounts) {
+    // Regression values for the opening position, checked against the brute force at depth 1
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, -1, -1, -1, -1, 1};
+    Board b(opening);
+    PerftResult r1 = perft(b, 1);
+    EXPECT_EQ(r1.leaves, bruteForceDepth1(b));
+    EXPECT_EQ(r1.leaves, 447);
+    EXPECT_EQ(r1.uniquePositions, 406);
+
+    PerftResult r2 = perft(b, 2);
+    EXPECT_EQ(r2.turns, 21 + r1.leaves * 21);
+    EXPECT_EQ(r2.leaves, 202782);
+    EXPECT_EQ(r2.uniquePositions, 163706);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../logic/Board.h"
+#include "../logic/PlayTree.h"
+
+TEST(PlayTreeTest, TranspositionsAreMerged) {
+    // A single checker for player 1 with a 2-1: 0->1->3 and 0->2->3 are the same play
+    int init_board[31] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1,
+                          0, 0, 2, 1, -1, -1, 1};
+    Board b(init_board);
+    PlayTree tree(b);
+    EXPECT_EQ(tree.playCount(), 1) << "Both orderings reach the same position";
+    EXPECT_EQ(tree.size(), 4) << "Start, after the 1, after the 2 and the shared final state";
+    auto plays = tree.plays();
+    ASSERT_EQ(plays.size(), 1);
+    EXPECT_EQ(plays[0].size(), 2);
+    EXPECT_EQ(tree.moves(0).size(), 2);
+}
+
+TEST(PlayTreeTest, DoublesSingleChecker) {
+    int init_board[31] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1,
+                          0, 0, 3, 3, 3, 3, 1};
+    Board b(init_board);
+    PlayTree tree(b);
+    EXPECT_EQ(tree.playCount(), 1);
+    auto plays = tree.plays();
+    ASSERT_EQ(plays.size(), 1);
+    EXPECT_EQ(plays[0].size(), 4) << "All four dice of the double must be played";
+}
+
+TEST(PlayTreeTest, HigherDieRule) {
+    // Same position as DFS_Test.MaxDiceUsedIfTieBreak1: only one die can be played, so it must be the 6
+    int init_board[31] = {0, 0, 0, 0, 1, 0, 0, 0, 0, -2, 0, -2,
+                          -2, -2, -2, -2, -2, -2, 0, 0, 0, 0, 0, 0,
+                          0, 0, 4, 6, -1, -1, 1};
+    Board b(init_board);
+    PlayTree tree(b);
+    auto plays = tree.plays();
+    ASSERT_EQ(plays.size(), 1);
+    ASSERT_EQ(plays[0].size(), 1);
+    EXPECT_EQ(plays[0][0], std::make_pair(4, 6));
+}
+
+TEST(PlayTreeTest, PrunedLeavesAreNotPlays) {
+    // Player 1's last checker bears off with either die and the turn ends: the higher-die rule keeps
+    // the 5, so the end state after the 4 (the same checkers, with the 5 unused) is not a play
+    int init_board[31] = {0, -10, 0, 0, -1, 0, -1, 0, 0, 0, 0, 0,
+                          0, 0, -1, -1, 0, -1, 0, 0, 0, 0, 0, 1,
+                          0, 0, 4, 5, -1, -1, 1};
+    Board b(init_board);
+    PlayTree tree(b);
+    std::vector<uint32_t> leaves;
+    tree.leaves(leaves);
+    EXPECT_EQ(tree.playCount(), 1);
+    EXPECT_EQ(leaves.size(), tree.plays().size());
+    EXPECT_EQ(b.legalPlays().size(), tree.playCount());
+    ASSERT_EQ(leaves.size(), 1);
+    EXPECT_EQ(tree.node(leaves[0]).edgeCount, 0);
+
+    // Positions of random games, many of them with pruned leaves
+    Rng rng(29);
+    Board game(rng);
+    std::vector<Play> plays;
+    for (int turn = 0; turn < 5000; ++turn) {
+        if (game.isGameOver()) {
+            game = Board(rng);
+        }
+        game.legalPlays(plays);
+        tree.build(game);
+        ASSERT_EQ(tree.playCount(), plays.size()) << "Turn " << turn;
+        game.applyPlay(plays[rng.below((uint32_t)plays.size())], rng);
+    }
+}
+
+TEST(PlayTreeTest, OpeningPlaysAreDistinct) {
+    for (int d1 = 1; d1 <= 6; ++d1) {
+        for (int d2 = d1; d2 <= 6; ++d2) {
+            int init_board[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                                  -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                                  0, 0, d1, d2, d1 == d2 ? d1 : -1, d1 == d2 ? d1 : -1, 1};
+            Board opening(init_board);
+            PlayTree tree(opening);
+            auto plays = tree.plays();
+            EXPECT_EQ(plays.size(), tree.playCount());
+            // Replaying every play must reach a distinct final position
+            std::vector<Position> finals;
+            for (const auto& play : plays) {
+                Board copy(opening);
+                for (const auto& m : play) {
+                    copy.move(m.first, m.second);
+                }
+                EXPECT_EQ(copy.diceLeft(), 0) << "Every opening roll can be fully played";
+                EXPECT_TRUE(std::find(finals.begin(), finals.end(), copy.position()) == finals.end());
+                finals.push_back(copy.position());
+            }
+        }
+    }
+}
+
+TEST(PlayTreeTest, StepFollowsCachedTree) {
+    int init_board[31] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1,
+                          0, 0, 2, 2, 2, 2, 1};
+    Board b(init_board);
+    for (int i = 0; i < 3; ++i) {
+        auto moves = b.validMoves();
+        ASSERT_EQ(moves.size(), 1);
+        b.step(moves[0].first, moves[0].second);
+        EXPECT_EQ(b.getCurrentPlayer(), 1) << "Turn is not over until the fourth 2 is played";
+    }
+    b.step(6, 2);
+    EXPECT_EQ(b.getCurrentPlayer(), -1);
+}
+
+
+TEST(PlayTreeTest, ApplyPlayMatchesSteps) {
+    // Playing a whole play at once must give the same game as stepping through its moves
+    Rng playRng(11), stepRng(11), choice(5);
+    Board byPlay(playRng);
+    Board bySteps(stepRng);
+    std::vector<Play> plays;
+    for (int turn = 0; turn < 2000 && !byPlay.isGameOver(); ++turn) {
+        byPlay.legalPlays(plays);
+        ASSERT_FALSE(plays.empty());
+        const Play& play = plays[choice.below((uint32_t)plays.size())];
+        byPlay.applyPlay(play, playRng);
+        if (play.empty()) {
+            bySteps.changePlayer(stepRng);
+        }
+        for (const Move& m : play) {
+            bySteps.step(m.from, m.distance, stepRng);
+        }
+        ASSERT_EQ(byPlay.position(), bySteps.position()) << "Turn " << turn;
+    }
+}
+
+TEST(PlayTreeTest, LegalPlaysAreDistinctAfterstates) {
+    int init_board[31] = {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 3,
+                          -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                          0, 0, 3, 3, 3, 3, 1};
+    Board b(init_board);
+    std::vector<Play> plays = b.legalPlays();
+    PlayTree tree(b);
+    EXPECT_EQ(plays.size(), tree.playCount());
+    std::vector<Position> afterstates;
+    for (const Play& play : plays) {
+        EXPECT_EQ(play.size(), 4);
+        Board copy(b);
+        for (const Move& m : play) {
+            copy.move(m.from, m.distance);
+        }
+        EXPECT_TRUE(std::find(afterstates.begin(), afterstates.end(), copy.position()) == afterstates.end());
+        afterstates.push_back(copy.position());
+    }
+
+    // Mid-turn, only the rest of the turn is returned
+    b.step(plays[0][0].from, plays[0][0].distance);
+    for (const Play& play : b.legalPlays()) {
+        EXPECT_EQ(play.size(), 3);
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/PositionKey.h"
+
+TEST(PositionKeyTest, OpeningMatchesGnubgId) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 3, 1, -1, -1, 1};
+    Board b(opening);
+    EXPECT_EQ(PositionKey::encode(b.position()).toId(), "4HPwATDgc/ABMA");
+
+    PositionKey key;
+    ASSERT_TRUE(PositionKey::fromId("4HPwATDgc/ABMA", key));
+    Position decoded;
+    ASSERT_TRUE(key.decode(1, decoded));
+    opening[26] = opening[27] = -1; // The key holds no dice
+    EXPECT_EQ(decoded, Board(opening).position());
+
+    EXPECT_FALSE(PositionKey::fromId("4HPwATDgc/ABM", key)) << "Too short";
+    EXPECT_FALSE(PositionKey::fromId("4HPwATDgc/AB!A", key)) << "Not Base64";
+}
+
+TEST(PositionKeyTest, MalformedIdsAreRejected) {
+    PositionKey key;
+    EXPECT_FALSE(PositionKey::fromId("////////////AA", key)) << "Ones everywhere: no separators";
+
+    // 16 checkers on the opponent's 1-point
+    PositionKey sixteen = {};
+    sixteen.bytes[0] = sixteen.bytes[1] = 0xFF;
+    EXPECT_FALSE(PositionKey::fromId(sixteen.toId(), key));
+
+    // 15 checkers per side use 80 bits exactly; one more checker for the player on roll needs 81
+    int full[31] = {15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -15,
+                    0, 0, -1, -1, -1, -1, 1};
+    const PositionKey fullKey = PositionKey::encode(Board(full).position());
+    ASSERT_TRUE(PositionKey::fromId(fullKey.toId(), key));
+    EXPECT_EQ(key, fullKey);
+    PositionKey overfull = fullKey;
+    overfull.bytes[9] |= 0x80; // Ones where the last separator must be
+    EXPECT_FALSE(PositionKey::fromId(overfull.toId(), key));
+
+    // With a checker borne off the key ends one bit earlier, and the bit after it must be clear
+    full[0] = 14;
+    PositionKey trailing = PositionKey::encode(Board(full).position());
+    ASSERT_TRUE(PositionKey::fromId(trailing.toId(), key));
+    trailing.bytes[9] |= 0x80;
+    EXPECT_FALSE(PositionKey::fromId(trailing.toId(), key));
+}
+
+TEST(PositionKeyTest, MalformedRecordsAreRejected) {
+    int opening[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                       -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                       0, 0, 3, 1, -1, -1, 1};
+    const Position expected = Board(opening).position();
+    const PositionRecord record = PositionRecord::encode(expected);
+    Position decoded = expected;
+
+    PositionRecord corrupted = record;
+    std::fill(corrupted.bytes, corrupted.bytes + 8, 0xFF); // The low 64 bits hold no separator
+    EXPECT_FALSE(corrupted.decode(decoded));
+
+    corrupted = record;
+    corrupted.bytes[0] = corrupted.bytes[1] = 0xFF; // A run of 16 checkers
+    corrupted.bytes[2] = 0;
+    EXPECT_FALSE(corrupted.decode(decoded));
+
+    corrupted = record;
+    corrupted.bytes[9] |= 0x80; // Ones after the last separator
+    EXPECT_FALSE(corrupted.decode(decoded));
+
+    corrupted = record;
+    corrupted.bytes[11] |= 0x40; // The unused bit of the dice word
+    EXPECT_FALSE(corrupted.decode(decoded));
+
+    corrupted = record;
+    corrupted.bytes[10] = 0xFF; // Dice digits past 5^6
+    corrupted.bytes[11] = 0x3F;
+    EXPECT_FALSE(corrupted.decode(decoded));
+
+    EXPECT_EQ(decoded, expected) << "Failed decodes leave the position unchanged";
+    ASSERT_TRUE(record.decode(decoded));
+    EXPECT_EQ(decoded, expected);
+}
+
+TEST(PositionKeyTest, KeyIsRelativeToPlayerOnRoll) {
+    // A position and its mirror image with the other player on roll share a key
+    int state[31] = {-2, 0, 2, -2, 0, -3, 0, -2, 2, 0, 1, 1,
+                     -3, 0, 1, 0, 2, -1, 2, 0, -2, 2, 0, 0,
+                     2, 1, 5, 3, -1, -1, 1};
+    int mirror[31];
+    for (int i = 0; i < 24; ++i) {
+        mirror[23 - i] = -state[i];
+    }
+    mirror[24] = state[25];
+    mirror[25] = state[24];
+    for (int i = 26; i < 30; ++i) {
+        mirror[i] = state[i];
+    }
+    mirror[30] = -state[30];
+    EXPECT_EQ(PositionKey::encode(Board(state).position()), PositionKey::encode(Board(mirror).position()));
+    EXPECT_NE(PositionRecord::encode(Board(state).position()), PositionRecord::encode(Board(mirror).position()));
+}
+
+TEST(PositionKeyTest, RecordsAndArraysRoundTrip) {
+    Rng rng(14);
+    for (int game = 0; game < 20; ++game) {
+        Board b(rng);
+        for (int ply = 0; ply < 600 && !b.isGameOver(); ++ply) {
+            PositionRecord record = PositionRecord::encode(b.position());
+            Position decoded;
+            ASSERT_TRUE(record.decode(decoded));
+            ASSERT_EQ(decoded, b.position()) << "Ply " << ply;
+            ASSERT_EQ(decoded.key, b.getKey());
+            ASSERT_EQ(decoded.pips[0], b.position().pips[0]);
+            ASSERT_EQ(decoded.inPlay[1], b.position().inPlay[1]);
+
+            int state[31];
+            b.toArray(state);
+            ASSERT_EQ(Board(state).position(), b.position()) << "Ply " << ply;
+
+            MoveList moves;
+            b.validMoves(moves);
+            if (moves.empty()) {
+                b.changePlayer(rng);
+            } else {
+                const Move& m = moves[rng.below((uint32_t)moves.size())];
+                b.step(m.from, m.distance, rng); // Mid-turn positions have partially used dice
+            }
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
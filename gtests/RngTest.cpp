@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "../logic/Board.h"
+#include "../logic/Rng.h"
+
+TEST(RngTest, SameSeedSameSequence) {
+    Rng a(42), b(42), c(43);
+    bool differs = false;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t x = a.next();
+        EXPECT_EQ(x, b.next());
+        differs |= (x != c.next());
+    }
+    EXPECT_TRUE(differs) << "Different seeds should give different sequences";
+
+    a.seed(7);
+    b.seed(7);
+    EXPECT_EQ(a.next(), b.next()) << "Reseeding restarts the sequence";
+}
+
+TEST(RngTest, DiceAreUniform) {
+    Rng rng(2024);
+    const int N = 600000;
+    int counts[6] = {0};
+    for (int i = 0; i < N; ++i) {
+        int face = rng.rollDie();
+        ASSERT_GE(face, 1);
+        ASSERT_LE(face, 6);
+        counts[face - 1]++;
+    }
+    // Chi-square with 5 degrees of freedom; 20.5 is the 0.1% critical value
+    double chi2 = 0;
+    for (int c : counts) {
+        double diff = c - N / 6.0;
+        chi2 += diff * diff / (N / 6.0);
+    }
+    EXPECT_LT(chi2, 20.5);
+}
+
+TEST(RngTest, SeededGamesAreReproducible) {
+    auto playGame = [](uint64_t seed) {
+        Rng rng(seed);
+        Board b(rng);
+        std::vector<std::pair<int, int>> history;
+        for (int ply = 0; ply < 2000 && !b.isGameOver(); ++ply) {
+            auto moves = b.validMoves();
+            if (moves.empty()) {
+                b.changePlayer(rng);
+                continue;
+            }
+            auto m = moves[rng.below((uint32_t)moves.size())];
+            history.push_back(m);
+            b.step(m.first, m.second, rng);
+        }
+        return history;
+    };
+    EXPECT_EQ(playGame(99), playGame(99));
+    EXPECT_NE(playGame(99), playGame(100));
+}
+
+TEST(RngTest, ThreadLocalGeneratorsAreIndependent) {
+    Rng* mainRng = &Rng::threadLocal();
+    Rng* otherRng = nullptr;
+    std::thread t([&otherRng]() { otherRng = &Rng::threadLocal(); });
+    t.join();
+    EXPECT_NE(mainRng, otherRng) << "Each thread owns its own generator";
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "../logic/Board.h"
+#include "../logic/Rollout.h"
+
+namespace {
+
+// Player 1 on roll with a checker on its 6-point, player 2 with a checker on its 1-point
+const int SIX_POINT_RACE[31] = {-1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+                                0, 0, -1, -1, -1, -1, 1};
+
+const int OPENING[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                         -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                         0, 0, 3, 1, -1, -1, 1};
+
+} // namespace
+
+TEST(RolloutTest, RotatedDiceAreExactOverABlock) {
+    // Player 1 bears off at once with 27 rolls out of 36, otherwise player 2 wins: equity 0.5.
+    // Rotating the first roll plays each roll once per 36 games, so the estimate is exact.
+    RolloutOptions options;
+    options.games = 36 * 10;
+    options.rotatedTurns = 1;
+    options.threads = 1;
+    RolloutResult r = rollout(Board(SIX_POINT_RACE), randomPolicy, options);
+    EXPECT_EQ(r.games, 360u);
+    EXPECT_DOUBLE_EQ(r.equity, 0.5);
+
+    // With random dice the estimate is only close
+    options.rotatedTurns = 0;
+    options.games = 4000;
+    r = rollout(Board(SIX_POINT_RACE), randomPolicy, options);
+    EXPECT_NEAR(r.equity, 0.5, 4 * r.standardError);
+    EXPECT_GT(r.standardError, 0.0);
+}
+
+TEST(RolloutTest, ResultDoesNotDependOnThreads) {
+    RolloutOptions options;
+    options.games = 48;
+    options.seed = 42;
+    options.threads = 1;
+    const RolloutResult one = rollout(Board(OPENING), randomPolicy, options);
+    options.threads = 4;
+    const RolloutResult four = rollout(Board(OPENING), randomPolicy, options);
+    EXPECT_EQ(one.equity, four.equity);
+    EXPECT_EQ(one.standardError, four.standardError);
+    EXPECT_GE(one.equity, -3.0);
+    EXPECT_LE(one.equity, 3.0);
+
+    options.seed = 43;
+    EXPECT_NE(rollout(Board(OPENING), randomPolicy, options).equity, one.equity);
+}
+
+TEST(RolloutTest, TruncationUsesTheEvaluator) {
+    // After one ply player 2 is on roll, and the evaluator's score is from player 1's point of view
+    RolloutOptions options;
+    options.games = 100;
+    options.threads = 2;
+    options.truncateAfter = 1;
+    options.evaluator = [](const Board& board) {
+        EXPECT_EQ(board.getCurrentPlayer(), -1);
+        for (int face = 0; face < 6; ++face) {
+            EXPECT_EQ(board.position().dice[face], 0) << "The player on roll has not rolled yet";
+        }
+        return 0.25;
+    };
+    RolloutResult r = rollout(Board(OPENING), randomPolicy, options);
+    EXPECT_EQ(r.truncated, 100u);
+    EXPECT_DOUBLE_EQ(r.equity, 0.25);
+    EXPECT_DOUBLE_EQ(r.standardError, 0.0);
+
+    // Seen from player 2, the same score is a loss
+    int state[31];
+    for (int i = 0; i < 31; ++i) {
+        state[i] = OPENING[i];
+    }
+    state[30] = -1;
+    options.evaluator = [](const Board&) { return 0.25; };
+    r = rollout(Board(state), randomPolicy, options);
+    EXPECT_DOUBLE_EQ(r.equity, -0.25);
+
+    // Truncating without an evaluator is reported to the caller, not on a worker thread
+    options.evaluator = nullptr;
+    EXPECT_THROW(rollout(Board(state), randomPolicy, options), std::invalid_argument);
+}
+
+TEST(RolloutTest, PolicyExceptionsReachTheCaller) {
+    // A policy that fails part way through the rollout, with one thread and with several
+    const PlayoutPolicy failing = [](const Board& board, const std::vector<Play>& plays, Rng& rng) -> size_t {
+        if (board.position().checkersOff(0) + board.position().checkersOff(1) > 0) {
+            throw std::runtime_error("Policy failed.");
+        }
+        return randomPolicy(board, plays, rng);
+    };
+    RolloutOptions options;
+    options.games = 200;
+    for (int threads : {1, 4}) {
+        options.threads = threads;
+        EXPECT_THROW(rollout(Board(OPENING), failing, options), std::runtime_error) << threads << " threads";
+    }
+}
+
+TEST(RolloutTest, PolicyChoosesThePlays) {
+    // A policy that always takes the first play gives the same games for the same dice
+    RolloutOptions options;
+    options.games = 48;
+    options.seed = 7;
+    PlayoutPolicy first = [](const Board&, const std::vector<Play>&, Rng&) { return (size_t)0; };
+    const RolloutResult a = rollout(Board(OPENING), first, options);
+    const RolloutResult b = rollout(Board(OPENING), first, options);
+    EXPECT_EQ(a.equity, b.equity);
+    EXPECT_EQ(a.truncated, 0u);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
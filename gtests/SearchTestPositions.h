@@ -0,0 +1,28 @@
+#ifndef SEARCHTESTPOSITIONS_H
+#define SEARCHTESTPOSITIONS_H
+#include <cmath>
+#include "../logic/Board.h"
+
+
+
+/**
+ * @file SearchTestPositions.h
+ * @brief Evaluator and positions shared by the search tests (Expectiminimax, MoveFilter).
+ */
+
+/**
+ * @brief A race evaluator: the pip count lead of the player on roll (who is worth about 8 pips).
+ */
+inline float pipEvaluator(const Board& board) {
+    const Position& position = board.position();
+    const int side = Position::sideIndex(board.getCurrentPlayer());
+    return std::tanh((float)(position.pips[side ^ 1] - position.pips[side] + 8) / 20.0f);
+}
+
+// Both sides bearing off, with player 1 on roll with 1-1 (most rolls have a single play here)
+const int RACE[31] = {-2, -1, -2, 0, -1, 0, 0, 0, 0, 0, 0, 0,
+                      0, 0, 0, 0, 0, 0, 1, 2, 0, 1, 1, 1,
+                      0, 0, 1, 1, 1, 1, 1};
+
+
+#endif // SEARCHTESTPOSITIONS_H
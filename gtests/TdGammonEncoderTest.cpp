@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/NeuralNet.h"
+#include "../logic/Rng.h"
+#include "../logic/TdGammonEncoder.h"
+
+namespace {
+
+const int OPENING[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                         -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                         0, 0, 3, 1, -1, -1, 1};
+
+// Boards met in random games, including bar and bear-off positions
+std::vector<Board> randomBoards(size_t count) {
+    std::vector<Board> boards;
+    Rng rng(17);
+    std::vector<Play> plays;
+    Board board(rng);
+    while (boards.size() < count) {
+        if (board.isGameOver()) {
+            board = Board(rng);
+        }
+        boards.push_back(board);
+        board.legalPlays(plays);
+        board.applyPlay(plays[rng.below((uint32_t)plays.size())], rng);
+    }
+    return boards;
+}
+
+std::vector<TdGammonEncoder> vectorEncoders() {
+    std::vector<TdGammonEncoder> encoders;
+#if defined(__x86_64__)
+    encoders.push_back(encodeTdGammonSse2);
+    if (__builtin_cpu_supports("avx2")) {
+        encoders.push_back(encodeTdGammonAvx2);
+    }
+#endif
+    encoders.push_back(tdGammonEncoder());
+    return encoders;
+}
+
+} // namespace
+
+TEST(TdGammonEncoderTest, EncodesTheOpeningPosition) {
+    std::vector<float> inputs(TD_GAMMON_INPUTS, -1.0f);
+    encodeTdGammon(Board(OPENING), inputs.data());
+
+    // Player 1 to move: 5 checkers on their 6-point, 3 on the 8-point, 5 on the 13-point, 2 on the 24-point
+    const float six[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float eight[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+    const float twentyFour[4] = {1.0f, 1.0f, 0.0f, 0.0f};
+    for (int unit = 0; unit < 4; ++unit) {
+        EXPECT_FLOAT_EQ(inputs[4 * 5 + unit], six[unit]);
+        EXPECT_FLOAT_EQ(inputs[4 * 7 + unit], eight[unit]);
+        EXPECT_FLOAT_EQ(inputs[4 * 12 + unit], six[unit]);
+        EXPECT_FLOAT_EQ(inputs[4 * 23 + unit], twentyFour[unit]);
+        EXPECT_FLOAT_EQ(inputs[4 * 0 + unit], 0.0f);
+    }
+    EXPECT_FLOAT_EQ(inputs[96], 0.0f);
+    EXPECT_FLOAT_EQ(inputs[97], 0.0f);
+
+    // The opening is symmetric: the opponent's block is the same
+    for (int unit = 0; unit < TD_GAMMON_SIDE_INPUTS; ++unit) {
+        EXPECT_FLOAT_EQ(inputs[TD_GAMMON_SIDE_INPUTS + unit], inputs[unit]) << unit;
+    }
+    EXPECT_FLOAT_EQ(inputs[196], 1.0f);
+    EXPECT_FLOAT_EQ(inputs[197], 0.0f);
+
+    int player2[31];
+    std::copy(OPENING, OPENING + 31, player2);
+    player2[30] = -1;
+    std::vector<float> other(TD_GAMMON_INPUTS);
+    encodeTdGammon(Board(player2), other.data());
+    for (int unit = 0; unit < 2 * TD_GAMMON_SIDE_INPUTS; ++unit) {
+        EXPECT_FLOAT_EQ(other[unit], inputs[unit]) << unit;
+    }
+    EXPECT_FLOAT_EQ(other[196], 0.0f);
+    EXPECT_FLOAT_EQ(other[197], 1.0f);
+}
+
+TEST(TdGammonEncoderTest, EncodesBarAndBorneOffCheckers) {
+    // Player 2 to move with 2 checkers on the bar and 13 borne off; player 1 has 15 checkers left,
+    // 14 of them on their 1-point and 1 on the bar
+    int state[31] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 14,
+                     1, 2, 4, 2, -1, -1, -1};
+    std::vector<float> inputs(TD_GAMMON_INPUTS);
+    encodeTdGammon(Board(state), inputs.data());
+    EXPECT_FLOAT_EQ(inputs[96], 1.0f);                  // Player 2 on the bar
+    EXPECT_FLOAT_EQ(inputs[97], 13.0f / 15.0f);         // Player 2 borne off
+    const float* opponent = inputs.data() + TD_GAMMON_SIDE_INPUTS;
+    EXPECT_FLOAT_EQ(opponent[0], 1.0f);                 // Player 1's 1-point
+    EXPECT_FLOAT_EQ(opponent[3], 5.5f);
+    EXPECT_FLOAT_EQ(opponent[96], 0.5f);
+    EXPECT_FLOAT_EQ(opponent[97], 0.0f);
+    EXPECT_FLOAT_EQ(inputs[197], 1.0f);
+}
+
+TEST(TdGammonEncoderTest, VectorEncodersMatchScalar) {
+    const std::vector<Board> boards = randomBoards(2000);
+    std::vector<float> expected(boards.size() * TD_GAMMON_INPUTS);
+    encodeTdGammonScalar(boards.data(), boards.size(), expected.data());
+    for (TdGammonEncoder encoder : vectorEncoders()) {
+        std::vector<float> inputs(boards.size() * TD_GAMMON_INPUTS, -1.0f);
+        encoder(boards.data(), boards.size(), inputs.data());
+        EXPECT_EQ(inputs, expected);
+    }
+
+    // The batch writes each row like a single encoding
+    std::vector<float> single(TD_GAMMON_INPUTS);
+    encodeTdGammon(boards[1234], single.data());
+    EXPECT_TRUE(std::equal(single.begin(), single.end(), expected.begin() + 1234 * TD_GAMMON_INPUTS));
+}
+
+TEST(TdGammonEncoderTest, FeedsNeuralNet) {
+    NeuralNet net;
+    ASSERT_TRUE(net.create({TD_GAMMON_INPUTS, 8, 1}));
+    net.setWeight(0, 196, 0, 4.0f); // The hidden unit turns on when player 1 is to move
+    net.setWeight(1, 0, 0, 8.0f);
+    net.setBias(1, 0, -4.0f);
+    std::vector<float> inputs(TD_GAMMON_INPUTS);
+    float output;
+    encodeTdGammon(Board(OPENING), inputs.data());
+    net.evaluate(inputs.data(), &output);
+    EXPECT_GT(output, 0.9f);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../logic/Board.h"
+#include "../logic/TranspositionTable.h"
+
+namespace {
+
+TranspositionTable::Entry makeEntry(float equity, uint8_t depth, uint16_t bestPlay = TranspositionTable::NO_PLAY) {
+    return TranspositionTable::Entry{equity, depth, TranspositionTable::Bound::EXACT, bestPlay};
+}
+
+} // namespace
+
+TEST(TranspositionTableTest, StoresAndFindsABoard) {
+    TranspositionTable table(1);
+    Board board;
+    TranspositionTable::Entry entry;
+    EXPECT_FALSE(table.probe(board.getKey(), entry));
+
+    table.store(board.getKey(), TranspositionTable::Entry{-0.25f, 3, TranspositionTable::Bound::LOWER, 7});
+    ASSERT_TRUE(table.probe(board.getKey(), entry));
+    EXPECT_FLOAT_EQ(entry.equity, -0.25f);
+    EXPECT_EQ(entry.depth, 3);
+    EXPECT_EQ(entry.bound, TranspositionTable::Bound::LOWER);
+    EXPECT_EQ(entry.bestPlay, 7);
+
+    // Same checkers, other dice: another key
+    int state[31] = {2, 0, 0, 0, 0, -5, 0, -3, 0, 0, 0, 5,
+                     -5, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, -2,
+                     0, 0, 6, 5, -1, -1, 1};
+    Board other(state);
+    board.setDice(4, 2);
+    other.setDice(4, 1);
+    table.store(board.getKey(), makeEntry(0.5f, 0));
+    EXPECT_FALSE(table.probe(other.getKey(), entry));
+
+    EXPECT_EQ(table.probes(), 3u);
+    EXPECT_EQ(table.hits(), 1u);
+    EXPECT_DOUBLE_EQ(table.hitRate(), 1.0 / 3.0);
+}
+
+TEST(TranspositionTableTest, KeepsTheDeeperResult) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry;
+    table.store(42, makeEntry(0.1f, 4));
+    table.store(42, makeEntry(0.2f, 2)); // Shallower, same search: ignored
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_FLOAT_EQ(entry.equity, 0.1f);
+
+    table.newSearch();
+    table.store(42, makeEntry(0.3f, 1)); // From an earlier search, so replaced
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_FLOAT_EQ(entry.equity, 0.3f);
+    EXPECT_EQ(table.collisions(), 0u);
+}
+
+TEST(TranspositionTableTest, FullBucketsEvictTheShallowest) {
+    TranspositionTable table(1);
+    const uint64_t stride = table.buckets(); // Keys equal modulo the bucket count share a bucket
+    for (uint64_t i = 0; i < TranspositionTable::BUCKET_ENTRIES; ++i) {
+        table.store(5 + i * stride, makeEntry((float)i, (uint8_t)(i + 1)));
+    }
+    EXPECT_EQ(table.collisions(), 0u);
+
+    table.store(5 + 9 * stride, makeEntry(9.0f, 3));
+    EXPECT_EQ(table.collisions(), 1u);
+    TranspositionTable::Entry entry;
+    EXPECT_FALSE(table.probe(5, entry)); // Depth 1, the shallowest
+    EXPECT_TRUE(table.probe(5 + 1 * stride, entry));
+    EXPECT_TRUE(table.probe(5 + 9 * stride, entry));
+
+    // After newSearch the old entries go first, however deep they are
+    table.newSearch();
+    table.store(5 + 10 * stride, makeEntry(10.0f, 0));
+    table.store(5 + 11 * stride, makeEntry(11.0f, 0));
+    EXPECT_TRUE(table.probe(5 + 10 * stride, entry));
+    EXPECT_TRUE(table.probe(5 + 11 * stride, entry));
+}
+
+TEST(TranspositionTableTest, ClearDropsEverything) {
+    TranspositionTable table(1);
+    for (uint64_t key = 1; key <= 1000; ++key) {
+        table.store(key * 0x9e3779b97f4a7c15ull, makeEntry(1.0f, 0));
+    }
+    EXPECT_GT(table.occupancy(), 0.0);
+    table.clear();
+    TranspositionTable::Entry entry;
+    EXPECT_FALSE(table.probe(0x9e3779b97f4a7c15ull, entry));
+    EXPECT_EQ(table.occupancy(), 0.0);
+    EXPECT_EQ(table.stores(), 0u);
+}
+
+TEST(TranspositionTableTest, ConcurrentWritersNeverMixEntries) {
+    // Every entry's equity and best play are derived from its key, so a torn read would show up
+    // as a hit whose fields do not match the key it was found under
+    TranspositionTable table(1);
+    const uint64_t stride = table.buckets();
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table, &mismatches, stride, t] {
+            TranspositionTable::Entry entry;
+            for (uint64_t i = 0; i < 20000; ++i) {
+                const uint64_t key = 3 + ((i * 7 + (uint64_t)t) % 16) * stride; // 16 keys in one bucket
+                if (table.probe(key, entry) && (entry.equity != (float)(key / stride) || entry.bestPlay != (uint16_t)(key / stride))) {
+                    mismatches++;
+                }
+                table.store(key, makeEntry((float)(key / stride), (uint8_t)(i % 8), (uint16_t)(key / stride)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(table.probes(), 80000u);
+    EXPECT_EQ(table.stores(), 80000u);
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
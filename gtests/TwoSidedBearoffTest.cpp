@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include "../logic/Board.h"
+#include "../logic/BearoffDatabase.h"
+#include "../logic/TwoSidedBearoff.h"
+
+namespace {
+
+// Small one-sided and two-sided databases shared by the tests, written once to temporary files
+class TwoSidedBearoffTest : public testing::Test {
+    protected:
+        static constexpr int CHECKERS = 3;
+        static std::string oneSidedPath;
+        static std::string twoSidedPath;
+
+        static void SetUpTestSuite() {
+            oneSidedPath = testing::TempDir() + "bearoff_one_sided.db";
+            twoSidedPath = testing::TempDir() + "bearoff_two_sided.db";
+            ASSERT_TRUE(BearoffDatabase::generate(oneSidedPath, CHECKERS));
+            ASSERT_TRUE(TwoSidedBearoff::generate(twoSidedPath, CHECKERS));
+        }
+
+        static void TearDownTestSuite() {
+            std::remove(oneSidedPath.c_str());
+            std::remove(twoSidedPath.c_str());
+        }
+
+        static uint32_t indexOf(std::initializer_list<uint8_t> counts) {
+            uint8_t c[BearoffDatabase::POINTS] = {};
+            int i = 0;
+            for (uint8_t n : counts) {
+                c[i++] = n;
+            }
+            return BearoffDatabase::index(c);
+        }
+};
+
+std::string TwoSidedBearoffTest::oneSidedPath;
+std::string TwoSidedBearoffTest::twoSidedPath;
+
+} // namespace
+
+TEST_F(TwoSidedBearoffTest, KnownValues) {
+    TwoSidedBearoff db;
+    ASSERT_TRUE(db.open(twoSidedPath));
+    EXPECT_EQ(db.checkers(), CHECKERS);
+    EXPECT_EQ(db.size(), 84u);
+
+    // The side on roll bears off a single checker on its 1-point with any roll
+    EXPECT_DOUBLE_EQ(db.winProbability(indexOf({1}), indexOf({1})), 1.0);
+
+    // A checker on the 6-point against a checker on the 1-point wins only if it is off at once
+    EXPECT_NEAR(db.winProbability(indexOf({0, 0, 0, 0, 0, 1}), indexOf({1})), 27.0 / 36.0, 1e-4);
+
+    // Three checkers on the 1-point need a double, otherwise the opponent wins
+    EXPECT_NEAR(db.winProbability(indexOf({3}), indexOf({1})), 6.0 / 36.0, 1e-4);
+
+    // Three on the 1-point against two on the 6-point: a double wins, otherwise the opponent only
+    // bears both off with 6-6, 5-5, 4-4 or 3-3
+    const double opponentMisses = 32.0 / 36.0;
+    EXPECT_NEAR(db.winProbability(indexOf({3}), indexOf({0, 0, 0, 0, 0, 2})),
+                6.0 / 36.0 + 30.0 / 36.0 * opponentMisses, 1e-4);
+}
+
+TEST_F(TwoSidedBearoffTest, AgreesWithOneSidedDatabase) {
+    TwoSidedBearoff two;
+    BearoffDatabase one;
+    ASSERT_TRUE(two.open(twoSidedPath));
+    ASSERT_TRUE(one.open(oneSidedPath));
+
+    // Against an opponent sure to finish next roll, the side on roll must bear off now
+    for (uint32_t i = 1; i < two.size(); ++i) {
+        EXPECT_NEAR(two.winProbability(i, indexOf({1})), one.probability(i, 1), 1e-4) << "Index " << i;
+        EXPECT_DOUBLE_EQ(two.winProbability(i, 0), 0.0) << "The opponent has already borne off";
+    }
+
+    // Every chance is a probability, and moving the opponent back only helps the side on roll
+    for (uint32_t i = 1; i < two.size(); ++i) {
+        for (uint32_t j = 1; j < two.size(); ++j) {
+            ASSERT_GE(two.winProbability(i, j), 0.0);
+            ASSERT_LE(two.winProbability(i, j), 1.0);
+        }
+    }
+    EXPECT_LT(two.winProbability(indexOf({0, 0, 2}), indexOf({1, 1})),
+              two.winProbability(indexOf({0, 0, 2}), indexOf({0, 1, 1})));
+}
+
+TEST_F(TwoSidedBearoffTest, LooksUpBoardPositions) {
+    TwoSidedBearoff db;
+    ASSERT_TRUE(db.open(twoSidedPath));
+
+    // Player 2 on roll with 2 checkers on its 2-point (point 1) against player 1's checker on its 4-point (point 20)
+    int state[31] = {0, -2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+                     0, 0, -1, -1, -1, -1, -1};
+    Board board(state);
+    ASSERT_TRUE(db.contains(board.position()));
+    EXPECT_DOUBLE_EQ(db.winProbability(board.position()), db.winProbability(indexOf({0, 2}), indexOf({0, 0, 0, 1})));
+
+    // A checker outside the home board or too many checkers cannot be looked up
+    state[11] = 1;
+    EXPECT_FALSE(db.contains(Board(state).position()));
+    state[11] = 0;
+    state[20] = 4;
+    EXPECT_FALSE(db.contains(Board(state).position()));
+}
+
+TEST(TwoSidedBearoffFileTest, RejectsOneSidedFiles) {
+    const std::string path = testing::TempDir() + "bearoff_wrong_kind.db";
+    ASSERT_TRUE(BearoffDatabase::generate(path, 2));
+    TwoSidedBearoff db;
+    EXPECT_FALSE(db.open(path));
+    EXPECT_FALSE(db.isOpen());
+    std::remove(path.c_str());
+}
+
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,273 @@
+#include "BearoffDatabase.h"
+#include "Board.h"
+#include "PlayTree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char MAGIC[8] = "BGBEAR1";
+
+// The point of a side that is its j-th point counted from its own 1-point (j = 0 to 5 in the home board)
+inline int pointFromOwn(int side, int j) { return side == 0 ? 23 - j : j; }
+
+// Binomial coefficients C(n, k) for n up to MAX_CHECKERS + POINTS
+struct Binomials {
+    uint32_t c[BearoffDatabase::MAX_CHECKERS + BearoffDatabase::POINTS + 1][BearoffDatabase::POINTS + 2];
+
+    Binomials() {
+        std::memset(c, 0, sizeof(c));
+        for (int n = 0; n <= BearoffDatabase::MAX_CHECKERS + BearoffDatabase::POINTS; ++n) {
+            c[n][0] = 1;
+            for (int k = 1; k <= BearoffDatabase::POINTS + 1 && k <= n; ++k) {
+                c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
+            }
+        }
+    }
+};
+
+const Binomials BINOMIALS;
+
+// Probability of bearing off in exactly n rolls, for n = first to first + size - 1
+struct Distribution {
+    int first = 0;
+    std::vector<double> p;
+    double mean = 0.0;
+};
+
+} // namespace
+
+uint32_t BearoffDatabase::positionCount(int checkers) {
+    return BINOMIALS.c[checkers + POINTS][POINTS];
+}
+
+uint32_t BearoffDatabase::index(const uint8_t counts[POINTS]) {
+    // Stars and bars: the counts and the checkers left over are a composition into POINTS + 1
+    // parts, and the positions of the POINTS separators are ranked in colexicographic order
+    uint32_t rank = 0;
+    int separator = 0;
+    for (int i = 0; i < POINTS; ++i) {
+        separator += counts[i];
+        rank += BINOMIALS.c[separator + i][i + 1];
+    }
+    return rank;
+}
+
+void BearoffDatabase::counts(uint32_t index, uint8_t counts[POINTS]) {
+    // Separator i is the largest s with C(s, i + 1) <= what is left of the rank
+    int separators[POINTS];
+    for (int i = POINTS - 1; i >= 0; --i) {
+        int separator = i;
+        while (separator + 1 <= MAX_CHECKERS + i && BINOMIALS.c[separator + 1][i + 1] <= index) {
+            ++separator;
+        }
+        index -= BINOMIALS.c[separator][i + 1];
+        separators[i] = separator;
+    }
+    int placed = 0;
+    for (int i = 0; i < POINTS; ++i) {
+        counts[i] = (uint8_t)(separators[i] - i - placed);
+        placed += counts[i];
+    }
+}
+
+void BearoffDatabase::successors(const uint8_t counts[POINTS], int high, int low, PlayTree& tree, std::vector<uint32_t>& result) {
+    // The side bears off alone: player 1 with its home board on points 18 to 23
+    Position position;
+    position.clear();
+    for (int j = 0; j < POINTS; ++j) {
+        position.setCount(0, pointFromOwn(0, j), counts[j]);
+    }
+    position.setCurrentPlayer(1);
+    if (high == low) {
+        position.setDice(high, 4);
+    } else {
+        position.setDice(high, 1);
+        position.setDice(low, 1);
+    }
+    tree.build(Board(position));
+
+    std::vector<uint32_t> leaves;
+    tree.leaves(leaves);
+    result.clear();
+    for (uint32_t leaf : leaves) {
+        result.push_back(index(tree.node(leaf).position, 0)); // Legal leaves are distinct plays
+    }
+}
+
+bool BearoffDatabase::generate(const std::string& path, int checkers) {
+    if (checkers < 1 || checkers > MAX_CHECKERS) {
+        return false;
+    }
+    // Every play lowers the pip count, so positions are solved from the fewest pips up
+    const uint32_t positions = positionCount(checkers);
+    std::vector<uint32_t> order(positions);
+    std::vector<int> pips(positions);
+    for (uint32_t i = 0; i < positions; ++i) {
+        uint8_t c[POINTS];
+        BearoffDatabase::counts(i, c);
+        for (int j = 0; j < POINTS; ++j) {
+            pips[i] += c[j] * (j + 1);
+        }
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return pips[a] < pips[b]; });
+
+    std::vector<Distribution> table(positions);
+    PlayTree tree;
+    std::vector<uint32_t> next;
+    for (uint32_t i : order) {
+        Distribution& result = table[i];
+        if (pips[i] == 0) {
+            result.p.assign(1, 1.0); // Already borne off
+            continue;
+        }
+        uint8_t c[POINTS];
+        BearoffDatabase::counts(i, c);
+
+        std::vector<double> sum;
+        int first = 0;
+        for (int high = 1; high <= 6; ++high) {
+            for (int low = 1; low <= high; ++low) {
+                // Play the roll to the successor with the fewest expected rolls
+                successors(c, high, low, tree, next);
+                const Distribution* best = &table[next[0]];
+                for (uint32_t n : next) {
+                    if (table[n].mean < best->mean) {
+                        best = &table[n];
+                    }
+                }
+
+                const double weight = (high == low ? 1.0 : 2.0) / 36.0;
+                const int start = best->first + 1;
+                if (sum.empty()) {
+                    first = start;
+                } else if (start < first) {
+                    sum.insert(sum.begin(), first - start, 0.0);
+                    first = start;
+                }
+                if (sum.size() < (size_t)(start - first) + best->p.size()) {
+                    sum.resize(start - first + best->p.size(), 0.0);
+                }
+                for (size_t n = 0; n < best->p.size(); ++n) {
+                    sum[start - first + n] += weight * best->p[n];
+                }
+            }
+        }
+        result.first = first;
+        result.p.swap(sum);
+        for (size_t n = 0; n < result.p.size(); ++n) {
+            result.mean += (first + n) * result.p[n];
+        }
+    }
+
+    // Quantize, keeping only the range that does not round to zero
+    std::vector<IndexEntry> entries(table.size());
+    std::vector<uint16_t> data;
+    for (size_t i = 0; i < table.size(); ++i) {
+        const Distribution& d = table[i];
+        size_t begin = 0;
+        size_t end = d.p.size();
+        while (begin < end && std::lround(d.p[begin] * 65535.0) == 0) {
+            ++begin;
+        }
+        while (end > begin && std::lround(d.p[end - 1] * 65535.0) == 0) {
+            --end;
+        }
+        IndexEntry& entry = entries[i];
+        entry.offset = (uint32_t)data.size();
+        entry.mean = (float)d.mean;
+        entry.first = (uint8_t)(d.first + begin);
+        entry.length = (uint8_t)(end - begin);
+        entry.reserved = 0;
+        for (size_t n = begin; n < end; ++n) {
+            data.push_back((uint16_t)std::lround(d.p[n] * 65535.0));
+        }
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.checkers = (uint32_t)checkers;
+    header.positions = (uint32_t)entries.size();
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(entries.data(), sizeof(IndexEntry), entries.size(), file) == entries.size();
+    ok = ok && std::fwrite(data.data(), sizeof(uint16_t), data.size(), file) == data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool BearoffDatabase::open(const std::string& path) {
+    if (!file.open(path)) {
+        return false;
+    }
+    if (file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    const Header& h = header();
+    const size_t dataStart = sizeof(Header) + (size_t)h.positions * sizeof(IndexEntry);
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0
+              && h.checkers >= 1 && h.checkers <= MAX_CHECKERS && h.positions == positionCount((int)h.checkers)
+              && file.size() >= dataStart && (file.size() - dataStart) % sizeof(uint16_t) == 0;
+    if (valid) {
+        // The data section ends with the last distribution, so a truncated file has an entry past its end
+        const size_t words = (file.size() - dataStart) / sizeof(uint16_t);
+        size_t end = 0;
+        for (uint32_t i = 0; i < h.positions; ++i) {
+            end = std::max(end, (size_t)entry(i).offset + entry(i).length);
+        }
+        valid = end == words;
+    }
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+int BearoffDatabase::checkers() const {
+    return (int)header().checkers;
+}
+
+uint32_t BearoffDatabase::size() const {
+    return header().positions;
+}
+
+bool BearoffDatabase::contains(const Position& position, int side) const {
+    return position.highestPoint(side) <= POINTS && position.inPlay[side] <= header().checkers;
+}
+
+uint32_t BearoffDatabase::index(const Position& position, int side) {
+    uint8_t counts[POINTS];
+    for (int j = 0; j < POINTS; ++j) {
+        counts[j] = position.count(side, pointFromOwn(side, j));
+    }
+    return index(counts);
+}
+
+double BearoffDatabase::meanRolls(uint32_t index) const {
+    return entry(index).mean;
+}
+
+double BearoffDatabase::probability(uint32_t index, int rolls) const {
+    const IndexEntry& e = entry(index);
+    if (rolls < e.first || rolls >= e.first + e.length) {
+        return 0.0;
+    }
+    return probabilities()[e.offset + (rolls - e.first)] / 65535.0;
+}
+
+double BearoffDatabase::probabilityWithin(uint32_t index, int rolls) const {
+    const IndexEntry& e = entry(index);
+    const uint16_t* p = probabilities() + e.offset;
+    double sum = 0.0;
+    for (int n = 0; n < e.length && e.first + n <= rolls; ++n) {
+        sum += p[n];
+    }
+    return sum / 65535.0;
+}
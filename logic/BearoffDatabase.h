@@ -0,0 +1,157 @@
+#ifndef BEAROFFDATABASE_H
+#define BEAROFFDATABASE_H
+#include <inttypes.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "MappedFile.h"
+
+class PlayTree;
+
+
+
+/**
+ * @file BearoffDatabase.h
+ * @brief One-sided bear-off database: the distribution of the number of rolls needed to bear off.
+ *
+ * A one-sided position is a side's checkers on its six home points, with no contact and nothing on
+ * the bar. Up to 15 checkers there are C(21, 6) = 54264 such positions, numbered by the
+ * combinatorial rank of index(). For each of them, generate() computes by dynamic programming the
+ * probability of bearing off in exactly n rolls when every roll is played to minimize the expected
+ * number of rolls. Plays are enumerated with PlayTree, so the table follows the engine's own
+ * bear-off rules.
+ *
+ * File layout (little-endian):
+ *   Header       magic "BGBEAR1", checkers, positions
+ *   Index        per position: offset of its distribution, mean rolls, first roll count, length
+ *   Data         probabilities as 16-bit fractions of 65535, only the non-zero range of each position
+ *
+ * open() maps the file read-only, so lookups are a couple of loads and the pages are shared
+ * between processes.
+ */
+class BearoffDatabase {
+    public:
+        static constexpr int POINTS = 6;       // Home board points
+        static constexpr int MAX_CHECKERS = 15;
+
+        BearoffDatabase() = default;
+        BearoffDatabase(const BearoffDatabase&) = delete;
+        BearoffDatabase& operator=(const BearoffDatabase&) = delete;
+
+        /**
+         * @brief Computes the database and writes it to a file.
+         * @param path The file to write.
+         * @param checkers The most checkers a position may have (1 to 15).
+         * @return false if the file could not be written.
+         */
+        static bool generate(const std::string& path, int checkers = MAX_CHECKERS);
+
+        /**
+         * @brief Maps a database file read-only.
+         * @param path The file written by generate().
+         * @return false if the file is missing, not a bear-off database, or truncated.
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Unmaps the file.
+         */
+        void close() { file.close(); }
+
+        bool isOpen() const { return file.data() != nullptr; }
+
+        /**
+         * @brief Gets the most checkers a position of the database may have.
+         */
+        int checkers() const;
+
+        /**
+         * @brief Gets the number of positions in the database.
+         */
+        uint32_t size() const;
+
+        /**
+         * @brief Returns the number of one-sided positions with up to a number of checkers.
+         */
+        static uint32_t positionCount(int checkers);
+
+        /**
+         * @brief Ranks a one-sided position.
+         * @param counts Checkers on the side's 1-point (next to bearing off) to 6-point.
+         * @return An index below positionCount(n) for positions of at most n checkers, so the
+         * positions of a smaller database are the first ones of a larger one.
+         */
+        static uint32_t index(const uint8_t counts[POINTS]);
+
+        /**
+         * @brief Unranks a one-sided position (the inverse of index()).
+         * @param index The index of the position.
+         * @param counts Set to the checkers on the side's 1-point to 6-point.
+         */
+        static void counts(uint32_t index, uint8_t counts[POINTS]);
+
+        /**
+         * @brief Lists the positions a one-sided position can be played to with a roll.
+         * Plays follow the engine's move generation; orderings of the same play are listed once.
+         * @param counts The position, checkers on the side's 1-point to 6-point.
+         * @param high The higher die.
+         * @param low The lower die (equal to high for a double).
+         * @param tree Storage for the play tree, reused across calls.
+         * @param result Set to the index of every distinct resulting position.
+         */
+        static void successors(const uint8_t counts[POINTS], int high, int low, PlayTree& tree, std::vector<uint32_t>& result);
+
+        /**
+         * @brief Checks whether a side of a position can be looked up: every checker is in its home board.
+         */
+        bool contains(const Position& position, int side) const;
+
+        /**
+         * @brief Ranks the home board of a side of a position (see contains()).
+         */
+        static uint32_t index(const Position& position, int side);
+
+        /**
+         * @brief Gets the expected number of rolls to bear off a position.
+         */
+        double meanRolls(uint32_t index) const;
+
+        /**
+         * @brief Gets the probability of bearing off a position in exactly a number of rolls.
+         */
+        double probability(uint32_t index, int rolls) const;
+
+        /**
+         * @brief Gets the probability of having borne off a position within a number of rolls.
+         */
+        double probabilityWithin(uint32_t index, int rolls) const;
+
+    private:
+        struct Header {
+            char magic[8];      // "BGBEAR1"
+            uint32_t checkers;  // Most checkers per position
+            uint32_t positions; // Number of index entries
+        };
+
+        struct IndexEntry {
+            uint32_t offset; // Position of the first probability in the data section (in 16-bit words)
+            float mean;      // Expected number of rolls
+            uint8_t first;   // Number of rolls of the first stored probability
+            uint8_t length;  // Number of stored probabilities
+            uint16_t reserved;
+        };
+
+        MappedFile file;
+
+        const Header& header() const { return *(const Header*)file.data(); }
+        const IndexEntry& entry(uint32_t index) const {
+            return ((const IndexEntry*)(file.data() + sizeof(Header)))[index];
+        }
+        const uint16_t* probabilities() const {
+            return (const uint16_t*)(file.data() + sizeof(Header) + header().positions * sizeof(IndexEntry));
+        }
+};
+
+
+#endif // BEAROFFDATABASE_H
@@ -1,7 +1,6 @@
 #include "Board.h"
+#include "Side.h"
 #include <stdexcept>
-#include <cstdlib>
-#include <ctime>
 #include <iostream>
 #include <cstring>
 #include <algorithm>
@@ -9,480 +8,392 @@
 #include <inttypes.h>
 #include <vector>
 
+// Per-thread cache of play trees used by validMoves() and step()
+namespace {
+constexpr uint8_t TURN_CACHE_SLOTS = 16;      // Number of play trees cached per thread
+constexpr uint32_t TURN_INDEX_SIZE = 1024;    // Entries of the key -> tree node index (power of two)
+
+struct TurnIndexEntry {
+    uint64_t key;  // Zobrist key of the state
+    uint32_t node; // Node of the play tree holding that state
+    uint8_t slot;  // Cache slot of that play tree
+};
+
+thread_local PlayTree turnCache[TURN_CACHE_SLOTS];        // Play trees of recently generated turns
+thread_local TurnIndexEntry turnIndex[TURN_INDEX_SIZE];   // Direct-mapped index of the states being played
+thread_local uint8_t nextTurnSlot = 0;                    // Next slot to overwrite (round robin)
+
+/**
+ * @brief Records that the state with a given key is a node of a cached play tree.
+ */
+void rememberTurnNode(uint64_t key, const PlayTree& tree, uint32_t node) {
+    turnIndex[key & (TURN_INDEX_SIZE - 1)] = TurnIndexEntry{key, node, (uint8_t)(&tree - turnCache)};
+}
+}
+
 Board::Board() {
     reset();
-    std::srand(static_cast<unsigned int>(std::time(nullptr))); // Seed the random number generator
+}
+
+Board::Board(Rng& rng) {
+    reset(rng);
+}
+
+Board::Board(const Position& position) : pos(position) {
 }
 
 Board::Board(const int boardState[31]) {
+    pos.clear();
     // Initialize player positions from the provided board state
     for (int i = 0; i < 24; ++i) {
         if (boardState[i] < 0) {
-            player1[i] = 0; 
-            player2[i] = (uint8_t)(-boardState[i]); 
-        } else {
-            player1[i] = (uint8_t)(boardState[i]); // Player 1's pieces
-            player2[i] = 0; // Player 2 has no pieces on this position
+            pos.setCount(1, i, (uint8_t)(-boardState[i])); // Player 2's pieces
+        } else if (boardState[i] > 0) {
+            pos.setCount(0, i, (uint8_t)(boardState[i])); // Player 1's pieces
         }
     }
-    bar1 = (uint8_t)boardState[24]; // Number of pieces on the bar for player 1
-    bar2 = (uint8_t)boardState[25]; // Number of pieces on the bar for player 2
+    pos.bar[0] = (uint8_t)boardState[24]; // Number of pieces on the bar for player 1
+    pos.bar[1] = (uint8_t)boardState[25]; // Number of pieces on the bar for player 2
     // Initialize dice and current player
-    std::fill(std::begin(dice), std::end(dice), 0);
     for (int i = 26; i < 30; ++i) {
         if (boardState[i] != -1) { // Check if the die is valid
-            dice[boardState[i] - 1] += 1; // Increment the count for the rolled die
+            pos.dice[boardState[i] - 1] += 1; // Increment the count for the rolled die
         }
     }
-    currentPlayer = boardState[30]; // Set the current player
-}
-
-Board::~Board() {
-    // Destructor does not need to do anything special for this implementation
-}
-
-Board::Board(const Board& other) {
-    // Deep copy of the board state
-    std::memcpy(this->player1, other.player1, sizeof(this->player1));
-    std::memcpy(this->player2, other.player2, sizeof(this->player2));
-    std::memcpy(this->dice, other.dice, sizeof(this->dice));
-    this->bar1 = other.bar1;
-    this->bar2 = other.bar2;
-    this->currentPlayer = other.currentPlayer;
+    pos.currentPlayer = (int8_t)boardState[30]; // Set the current player
+    pos.refresh(); // Fields above were written directly
 }
 
-Board& Board::operator=(const Board& other) {
-    if (this != &other) { // Check for self-assignment
-        // Deep copy of the board state
-        std::memcpy(this->player1, other.player1, sizeof(this->player1));
-        std::memcpy(this->player2, other.player2, sizeof(this->player2));
-        std::memcpy(this->dice, other.dice, sizeof(this->dice));
-        this->bar1 = other.bar1;
-        this->bar2 = other.bar2;
-        this->currentPlayer = other.currentPlayer;
+void Board::toArray(int boardState[31]) const {
+    for (int i = 0; i < 24; ++i) {
+        boardState[i] = pos.count(0, i) - pos.count(1, i); // A point never holds checkers of both players
+    }
+    boardState[24] = pos.bar[0];
+    boardState[25] = pos.bar[1];
+    int die = 26;
+    for (int face = 1; face <= 6; ++face) {
+        for (int n = 0; n < pos.dice[face - 1] && die < 30; ++n) {
+            boardState[die++] = face;
+        }
     }
-    return *this;
+    while (die < 30) {
+        boardState[die++] = -1; // No die
+    }
+    boardState[30] = pos.currentPlayer;
 }
 
-void Board::reset() {
+void Board::reset(Rng& rng) {
     // Initialize player positions
-    std::fill(std::begin(player1), std::end(player1), 0);
-    std::fill(std::begin(player2), std::end(player2), 0);
+    pos.clear();
 
-    player1[0] = 2; // Player 1 starts with 2 pieces on position 0
-    player2[23] = 2; // Player 2 starts with 2 pieces on position 23
+    pos.setCount(0, 0, 2); // Player 1 starts with 2 pieces on position 0
+    pos.setCount(1, 23, 2); // Player 2 starts with 2 pieces on position 23
 
-    player1[11] = 5; // Player 1 has 5 pieces on position 11
-    player2[12] = 5; // Player 2 has 5 pieces on position 12
+    pos.setCount(0, 11, 5); // Player 1 has 5 pieces on position 11
+    pos.setCount(1, 12, 5); // Player 2 has 5 pieces on position 12
 
-    player1[16] = 3; // Player 1 has 3 pieces on position 16
-    player2[7] = 3; // Player 2 has 3 pieces on position 7
+    pos.setCount(0, 16, 3); // Player 1 has 3 pieces on position 16
+    pos.setCount(1, 7, 3); // Player 2 has 3 pieces on position 7
 
-    player1[18] = 5; // Player 1 has 5 pieces on position 18
-    player2[5] = 5; // Player 2 has 5 pieces on position 5
+    pos.setCount(0, 18, 5); // Player 1 has 5 pieces on position 18
+    pos.setCount(1, 5, 5); // Player 2 has 5 pieces on position 5
 
-    // Reset dice values
-    std::fill(std::begin(dice), std::end(dice), 0); // Set all dice to 0 (not rolled)
-    
     // Simulate the initial dice roll to determine the starting player
     int player1_dice = -1;
     int player2_dice = -1;
     do {
-        player1_dice = std::rand() % 6 + 1; // Random number between 1 and 6
-        player2_dice =  std::rand() % 6 + 1; // Random number between 1 and 6
+        player1_dice = rng.rollDie(); // Random number between 1 and 6
+        player2_dice = rng.rollDie(); // Random number between 1 and 6
     } while (player1_dice == player2_dice); // Ensure the dice are not equal
     
-    currentPlayer = (player1_dice > player2_dice) ? 1 : -1; // Determine the starting player based on dice values
-    dice[player1_dice - 1] = 1;                             // Mark the rolled die for player 1
-    dice[player2_dice - 1] = 1;                             // Mark the rolled die for player 2
-    bar1 = 0; // Player 1 has no pieces on the bar
-    bar2 = 0; // Player 2 has no pieces on the bar
+    pos.setCurrentPlayer((player1_dice > player2_dice) ? 1 : -1); // Determine the starting player based on dice values
+    pos.setDice(player1_dice, 1);                                 // Mark the rolled die for player 1
+    pos.setDice(player2_dice, 1);                                 // Mark the rolled die for player 2
 }
 
-void Board::rollDice() {
+void Board::rollDice(Rng& rng) {
     // Roll the dice for the current player
-    std::fill(std::begin(dice), std::end(dice), 0); // Reset dice to 0 (not available)
-    int dice1 = std::rand() % 6 + 1; // Random number between 1 and 6
-    int dice2 = std::rand() % 6 + 1; // Random number between 1 and 6
+    int roll = (int)rng.below(36); // Both dice from a single unbiased draw
+    setDice(roll / 6 + 1, roll % 6 + 1);
+}
+
+void Board::setDice(int dice1, int dice2) {
+    for (int face = 1; face <= 6; ++face) {
+        pos.setDice(face, 0); // Reset dice to 0 (not available)
+    }
     if (dice1 == dice2) {
         // If the dice are equal, it's a double roll
-        dice[dice1 - 1] = 4; // 4 available moves for doubles
+        pos.setDice(dice1, 4); // 4 available moves for doubles
     } else {
         // Store the rolled values in the first two slots
-        dice[dice1 - 1] = 1; 
-        dice[dice2 - 1] = 1;
+        pos.setDice(dice1, 1); 
+        pos.setDice(dice2, 1);
     }
 }
 
-void Board::changePlayer() {
+void Board::changePlayer(Rng& rng) {
     // Change the current player
-    currentPlayer = (currentPlayer == 1) ? -1 : 1; // Toggle between player 1 and player 2 (ternary operator faster than multiplication)
-    rollDice(); // Roll the dice for the new player
+    pos.setCurrentPlayer((pos.currentPlayer == 1) ? -1 : 1); // Toggle between player 1 and player 2 (ternary operator faster than multiplication)
+    rollDice(rng); // Roll the dice for the new player
 }
 
 int Board::getCurrentPlayer() const {
-    return currentPlayer; // Return the current player
+    return pos.currentPlayer; // Return the current player
 }
 
-void Board::step(int from, int distance) {
+void Board::step(int from, int distance, Rng& rng) {
+    uint32_t node;
+    const PlayTree* tree = &turnTree(node);
+    int64_t next = tree->child(node, from, distance); // Look up the move in this turn's play tree
     move(from, distance); // Move the piece from the specified position
-    if (std::all_of(dice, dice + 6, [](uint8_t d) { return d == 0; })) {
-        // If all dice have been used, change the player and roll new dice
-        changePlayer();
-        rollDice();
+    if (next >= 0) {
+        node = (uint32_t)next; // The tree already knows the state after the move
+        rememberTurnNode(pos.key, *tree, node);
+    } else {
+        tree = &turnTree(node); // Not a move of the cached tree, generate from the new state
     }
-    else {
-        // If there are still dice available, check to see if the player can make any valid moves
-        auto moves = validMoves();
-        if (moves.empty()) {
-            // If no valid moves are available, change the player and roll new dice
-            changePlayer();
-            rollDice();
-        }
+    if (tree->node(node).edgeCount == 0) {
+        // If all dice have been used or no valid moves are left, change the player and roll new dice
+        changePlayer(rng);
     }
 }
 
-void Board::move(int from, int distance) {
-    (currentPlayer == 1) ? handlePlayer1Move(from, distance) : handlePlayer2Move(from, distance);
+void Board::applyPlay(const Play& play, Rng& rng) {
+    for (const Move& m : play) {
+        doMove(m.from, m.distance);
+    }
+    changePlayer(rng);
 }
 
-
-// std::vector<std::pair<int, int>> Board::validMoves() const {
-//     return (currentPlayer == 1) ? validMovesPlayer1() : validMovesPlayer2();
-// }
-
-std::vector<std::pair<int, int>> Board::validMoves() const {
-    return (currentPlayer == 1) ? validMovesDFS1() : validMovesDFS2();
+void Board::move(int from, int distance) {
+    doMove(from, distance);
 }
 
+MoveUndo Board::doMove(int from, int distance) {
+    return (pos.currentPlayer == 1) ? doMove<1>(from, distance) : doMove<-1>(from, distance);
+}
 
+void Board::undoMove(const MoveUndo& undo) {
+    (pos.currentPlayer == 1) ? undoMove<1>(undo) : undoMove<-1>(undo);
+}
 
-//////////////////////////////////////////////////
-//// HELPER FUNCTIONS FOR VALID MOVES ////
-//////////////////////////////////////////////////
+template <int Player>
+MoveUndo Board::doMove(int from, int distance) {
+    using S = Side<Player>;
+    MoveUndo undo{(int8_t)from, (int8_t)distance, 0, 0};
+    int targetPosition;
+    if (distance == 7) {
+        // If distance is 7, it means placing a piece from the bar
+        pos.setBar(S::INDEX, pos.bar[S::INDEX] - 1);
+        undo.flags |= MoveUndo::FROM_BAR;
+        undo.die = (uint8_t)S::entryDie(from);
+        targetPosition = from;
+    } else {
+        pos.removeChecker(S::INDEX, from); // Remove a piece from the starting position
+        undo.die = (uint8_t)(distance * S::DIRECTION);
+        targetPosition = from + distance; // Calculate the target position
+    }
+    if (S::onBoard(targetPosition)) { // Otherwise the piece is borne off
+        pos.addChecker(S::INDEX, targetPosition); // Place a piece in the target position
+        if (pos.count(S::OPPONENT, targetPosition) == 1) {
+            pos.setCount(S::OPPONENT, targetPosition, 0);
+            pos.setBar(S::OPPONENT, pos.bar[S::OPPONENT] + 1); // If there was an opponent's piece, move it to the bar
+            undo.flags |= MoveUndo::HIT;
+        }
+    }
+    pos.setDice(undo.die, pos.dice[undo.die - 1] - 1); // Mark the die as used
+    return undo;
+}
 
-/**
- * @brief Returns the minimum amount of die left that can be possible for player 1 given a board. 
- * This function recursively checks all valid moves for player 1 and returns the minimum die left after making those moves.
- * @param b The current board state.
- * @return The minimum die left for player 1 after making valid moves.
- */
-int getMinimumDieLeft1(Board b) {
-    auto moves = b.validMovesPlayer1(); 
-    if (moves.empty()) {
-        return b.diceLeft(); 
+template <int Player>
+void Board::undoMove(const MoveUndo& undo) {
+    using S = Side<Player>;
+    const int target = (undo.flags & MoveUndo::FROM_BAR) ? undo.from : undo.from + undo.distance;
+    if (S::onBoard(target)) {
+        pos.removeChecker(S::INDEX, target); // Take the piece back from where it landed (nothing to do if borne off)
+    }
+    if (undo.flags & MoveUndo::HIT) {
+        pos.setCount(S::OPPONENT, target, 1); // Put the hit blot back on its point
+        pos.setBar(S::OPPONENT, pos.bar[S::OPPONENT] - 1);
     }
-    int minDie = 7; // Initialize to a value greater than the amount of dice available
-    for (const auto& move : moves) {
-        int c = getMinimumDieLeft1(b.stepReturn(move.first, move.second)); // Recursively check the next state
-        minDie = std::min(minDie, c); // Update the minimum die found
+    if (undo.flags & MoveUndo::FROM_BAR) {
+        pos.setBar(S::INDEX, pos.bar[S::INDEX] + 1); // The piece goes back on the bar
+    } else {
+        pos.addChecker(S::INDEX, undo.from);
     }
-    return minDie; // Return the minimum die found
+    pos.setDice(undo.die, pos.dice[undo.die - 1] + 1); // Give the die back
 }
 
+template MoveUndo Board::doMove<1>(int from, int distance);
+template MoveUndo Board::doMove<-1>(int from, int distance);
+template void Board::undoMove<1>(const MoveUndo& undo);
+template void Board::undoMove<-1>(const MoveUndo& undo);
 
-std::vector<std::pair<int, int>> Board::validMovesDFS1() const {
-    auto moves = validMovesPlayer1(); // Get all valid moves for player 1
-    if (moves.empty()) {
-        return moves; // Return empty if no valid moves
-    }
 
-    std::vector<int> diceLeftPossible(moves.size(), 8); // Set dice left to a value greater than possible
-    int dieLeftMin = 7; // Initialize minimum die left greater than the maximum possible (4) 
-    for (size_t i = 0; i < moves.size(); ++i) {
-        Board b = stepReturn(moves[i].first, moves[i].second); // Get the board state after the move
-        diceLeftPossible[i] = getMinimumDieLeft1(b); // Get the minimum die used in the next state
-        dieLeftMin = std::min(dieLeftMin, diceLeftPossible[i]); // Update the minimum die found
-    }
-    std::vector<std::pair<int, int>> validMoves;
-    if (dieLeftMin == 0) { // Return any move that can use all possible die
-        for (size_t i = 0; i < moves.size(); ++i) {
-            if (diceLeftPossible[i] == 0) { // If the move uses the minimum die found
-                validMoves.push_back(moves[i]); 
-            }
-        }
-        return validMoves; // Return valid moves if minimum die is 0
-    }
+std::vector<std::pair<int, int>> Board::validMoves() const {
+    MoveList moves;
+    validMoves(moves);
+    return moves.toVector();
+}
 
-    // If there are no moves that use all possible dice, we can only choose moves that use the highest possible die. 
-    int maxDice = 0; // Variable to track the maximum die used (set to 0 (impossible))
-    for (size_t i = 0; i < moves.size(); ++i) {
-        if (diceLeftPossible[i] == dieLeftMin) { // If the move uses the minimum die found
-            maxDice = std::max(maxDice, moves[i].second); // Update the maximum die used
-        }
-    }
+void Board::validMoves(MoveList& moves) const {
+    uint32_t node;
+    const PlayTree& tree = turnTree(node);
+    tree.moves(node, moves);
+}
 
-    for (size_t i = 0; i < moves.size(); ++i) {
-        if (diceLeftPossible[i] == dieLeftMin && moves[i].second == maxDice) { // If the move uses the most amount of die and has highest dice face. 
-            validMoves.push_back(moves[i]); 
-        }
-    }
-    return validMoves; // Return valid moves
+std::vector<Play> Board::legalPlays() const {
+    std::vector<Play> plays;
+    legalPlays(plays);
+    return plays;
 }
 
-/**
- * @brief Returns the minimum amount of die left that can be possible for player 1 given a board. 
- * This function recursively checks all valid moves for player 1 and returns the minimum die left after making those moves.
- * @param b The current board state.
- * @return The minimum die left for player 1 after making valid moves.
- */
-int getMinimumDieLeft2(Board b) {
-    auto moves = b.validMovesPlayer2(); 
-    if (moves.empty()) {
-        return b.diceLeft(); 
-    }
-    int minDie = 7; // Initialize to a value greater than the amount of dice available
-    for (const auto& move : moves) {
-        int c = getMinimumDieLeft2(b.stepReturn(move.first, move.second)); // Recursively check the next state
-        minDie = std::min(minDie, c); // Update the minimum die found
-    }
-    return minDie; // Return the minimum die found
+void Board::legalPlays(std::vector<Play>& plays) const {
+    uint32_t node;
+    const PlayTree& tree = turnTree(node);
+    tree.plays(plays, node);
 }
 
 
 
-/**
- * @brief Returns all valid moves for player 2 using a depth-first search approach.
- * This method checks player 2's pieces and the rolled dice to determine all possible moves.
- * This method is used to explore all possible moves for player 2 and make sure it only returns moves
- * that are valid according to the game rules (using moves that allow the maximum amount of dice to be used).
- * @return A vector of pairs, where each pair contains the starting position and the distance to move.
- */
-std::vector<std::pair<int, int>> Board::validMovesDFS2() const {
-    auto moves = validMovesPlayer2(); // Get all valid moves for player 1
-    if (moves.empty()) {
-        return moves; // Return empty if no valid moves
-    }
+//////////////////////////////////////////////////
+//// HELPER FUNCTIONS FOR VALID MOVES ////
+//////////////////////////////////////////////////
 
-    std::vector<int> diceLeftPossible(moves.size(), 8); // Set dice left to a value greater than possible
-    int dieLeftMin = 7; // Initialize minimum die left greater than the maximum possible (4) 
-    for (size_t i = 0; i < moves.size(); ++i) {
-        Board b = stepReturn(moves[i].first, moves[i].second); // Get the board state after the move
-        diceLeftPossible[i] = getMinimumDieLeft2(b); // Get the minimum amount of die left
-        dieLeftMin = std::min(dieLeftMin, diceLeftPossible[i]); 
-    }
-    std::vector<std::pair<int, int>> validMoves;
-    if (dieLeftMin == 0) { // Return any move that can use all possible die
-        for (size_t i = 0; i < moves.size(); ++i) {
-            if (diceLeftPossible[i] == 0) { // If the move uses the minimum die found
-                validMoves.push_back(moves[i]); 
-            }
+const PlayTree& Board::turnTree(uint32_t& node) const {
+    const TurnIndexEntry& entry = turnIndex[pos.key & (TURN_INDEX_SIZE - 1)];
+    if (entry.key == pos.key) {
+        const PlayTree& cached = turnCache[entry.slot];
+        if (entry.node < cached.size() && cached.node(entry.node).position == pos) {
+            node = entry.node;
+            return cached; // Same state as when the tree was built or stepped
         }
-        return validMoves; // Return valid moves if minimum die is 0
     }
+    PlayTree& tree = turnCache[nextTurnSlot];
+    nextTurnSlot = (nextTurnSlot + 1) % TURN_CACHE_SLOTS;
+    tree.build(*this);
+    node = 0;
+    rememberTurnNode(pos.key, tree, node);
+    return tree;
+}
 
-    // If there are no moves that use all possible dice, we can only choose moves that use the highest possible die. 
-    int minDice = 0; // Variable to track the maximum die used (set to -7 for player2 (impossible))
-    for (size_t i = 0; i < moves.size(); ++i) {
-        if (diceLeftPossible[i] == dieLeftMin) { // If the move uses the minimum die found
-            minDice = std::min(minDice, moves[i].second); // Using min here because player 2 has negative to 
-        }
+template <int Player>
+int Board::winMargin() const {
+    using S = Side<Player>;
+    if (pos.occupied[S::INDEX] != 0 || pos.bar[S::INDEX] != 0) {
+        return 0; // Player still has pieces to bear off
     }
-
-    for (size_t i = 0; i < moves.size(); ++i) {
-        if (diceLeftPossible[i] == dieLeftMin && moves[i].second == minDice) { // If the move uses the most amount of die and has highest dice face. 
-            validMoves.push_back(moves[i]); 
-        }
+    if (pos.bar[S::OPPONENT] > 0 || (pos.occupied[S::OPPONENT] & S::HOME)) {
+        return 3; // Backgammon: opponent still on the bar or in the winner's home board
+    }
+    else if (pos.checkersOff(S::OPPONENT) == 0) {
+        return 2; // Gammon: opponent has not borne off any piece
     }
-    return validMoves; // Return valid moves
+    return 1; // Normal win
 }
 
 int Board::getOutcome() const {
     // Check if player 1 has won
-    if (std::all_of(player1, player1 + 24, [](uint8_t p) { return p == 0; }) && bar1 == 0) {
-        if (bar2 > 0 || std::any_of(player2 + 18, player2 + 24, [](uint8_t p) { return p > 0; })) {
-            return 3; // Player 1 wins with a backgammon
-        }
-        else if (std::accumulate(player2, player2 + 24, 0) == 15) {
-            return 2; // Player 1 wins with a gammon
-        }
-        return 1; // Player 1 wins normally
+    int margin = winMargin<1>();
+    if (margin != 0) {
+        return margin;
     }
 
     // Check if player 2 has won
-    if (std::all_of(player2, player2 + 24, [](uint8_t p) { return p == 0; }) && bar2 == 0) {
-        if (bar1 > 0 || std::any_of(player1, player1 + 6, [](uint8_t p) { return p > 0; })) {
-            return -3; // Player 2 wins with a backgammon
-        }
-        else if (std::accumulate(player1, player1 + 24, 0) == 15) {
-            return -2; // Player 2 wins with a gammon
-        }
-        return -1; // Player 2 wins normally
-    }
-
-
-    return 0; // Game is still ongoing
+    return -winMargin<-1>(); // 0 if the game is still ongoing
 }
 
 std::vector<std::pair<int, int>> Board::validMovesPlayer1() const {
-    std::vector<std::pair<int, int>> moves;
-
-    // Check if player 1 has pieces on the bar (must place a piece from the bar)
-    if (bar1 > 0) {
-        for (int i = 0; i < 6; ++i) {
-            if (dice[i] > 0) { // Check if the die is valid
-                int targetPosition = i; // Calculate target position based on the die rolled
-                if (player2[targetPosition] <= 1) {
-                    moves.emplace_back(targetPosition, 7); // Move from bar to target position (7 signifies emplacement move)
-                }
-            }
-        }
-        return moves; // Return moves if pieces are on the bar
-    }
-
-    // Check for bearing off 
-    // If all pieces are in the home board, from position 0 to 17 inclusive are zero
-    if (std::all_of(player1, player1 + 18, [](uint8_t p) { return p == 0; })) {
-        for (int i = 0; i < 6; ++i) {
-            if (dice[i] > 0) { // Check if the die is valid
-                int targetPosition = 23 - i; // Calculate target position for bearing off
-                if (player1[targetPosition] > 0) {
-                    moves.emplace_back(targetPosition, i + 1); // Must bear off a piece
-                } else {
-                    // Check to see if there are any pieces higher than the target position that can be beared off
-                    bool higherPieceFound = false;
-                    for (int j = targetPosition - 1; j >= 18; --j) {
-                        if (player1[j] > 0 && player2[j + i + 1] <= 1) {
-                            moves.emplace_back(j, i + 1); // Move a piece from a higher position
-                            higherPieceFound = true;
-                        }
-                    }
-                    if (!higherPieceFound) {
-                        // If no higher pieces found, bear off the next available lower piece 
-                        for (int j = targetPosition + 1; j < 24; ++j) {
-                            if (player1[j] > 0) {
-                                moves.emplace_back(j, i + 1); // Bear off next available piece
-                                break; // Exit loop after finding piece to bear off. 
-                            }
-                        }
-                    }
+    MoveList moves;
+    generateMoves<1>(moves);
+    return moves.toVector();
+}
 
-                }
-            }
-        }
-        return moves; // Return moves if bearing off is possible
-    }
+void Board::validMovesPlayer1(MoveList& moves) const {
+    generateMoves<1>(moves);
+}
 
-    // Check each piece on the board for valid moves
-    for (int i = 0; i < 24; ++i) {
-        if (player1[i] > 0) { // Player 1 has pieces on this position
-            for (int j = 0; j < 6; ++j) {
-                if (dice[j] > 0) { // Check if the die is available
-                    int targetPosition = i + j + 1; // Calculate target position
-                    if (targetPosition < 24 && player2[targetPosition] <= 1) { // Valid move to an open point (can't bear off)
-                        moves.emplace_back(i, j + 1); // Add valid move
-                    }
-                }
-            }
-        }
-    }
+std::vector<std::pair<int, int>> Board::validMovesPlayer2() const {
+    MoveList moves;
+    generateMoves<-1>(moves);
+    return moves.toVector();
+}
 
-    return moves; // Return all valid moves for player 1
+void Board::validMovesPlayer2(MoveList& moves) const {
+    generateMoves<-1>(moves);
 }
 
-std::vector<std::pair<int, int>> Board::validMovesPlayer2() const {
-    std::vector<std::pair<int, int>> moves;
-
-    // Check if player 1 has pieces on the bar (must place a piece from the bar)
-    if (bar2 > 0) {
-        for (int i = 0; i < 6; ++i) {
-            if (dice[i] > 0) { // Check if the die is valid
-                int targetPosition = 23 - i; // Calculate target position based on the die rolled
-                if (player1[targetPosition] <= 1) {
+template <int Player>
+void Board::generateMoves(MoveList& moves) const {
+    using S = Side<Player>;
+    moves.clear();
+
+    // Check if the player has pieces on the bar (must place a piece from the bar)
+    if (pos.bar[S::INDEX] > 0) {
+        for (int die = 1; die <= 6; ++die) {
+            if (pos.dice[die - 1] > 0) { // Check if the die is valid
+                int targetPosition = S::entryPoint(die); // Calculate target position based on the die rolled
+                if (!pos.isBlocked(S::INDEX, targetPosition)) {
                     moves.emplace_back(targetPosition, 7); // Move from bar to target position (7 signifies emplacement move)
                 }
             }
         }
-        return moves; // Return moves if pieces are on the bar
+        return; // Only bar entries are allowed while pieces are on the bar
     }
 
-    
-    // If all pieces are in the home board, from position 6 to 23 are zero
-    if (std::all_of(player2 + 6, player2 + 24, [](uint8_t p) { return p == 0; })) {
-        for (int i = 0; i < 6; ++i) {
-            if (dice[i] > 0) { // Check if the die is valid
-                int targetPosition = i; // Calculate target position for bearing off
-                if (player2[targetPosition] > 0) {
-                    moves.emplace_back(targetPosition, - (i + 1)); // Must bear off a piece
+    // Check for bearing off 
+    // If all pieces are in the home board, every point outside of it is empty
+    if ((pos.occupied[S::INDEX] & S::OUTSIDE_HOME) == 0) {
+        for (int die = 1; die <= 6; ++die) {
+            if (pos.dice[die - 1] > 0) { // Check if the die is valid
+                int targetPosition = S::bearOffPoint(die); // Calculate target position for bearing off
+                if (pos.hasChecker(S::INDEX, targetPosition)) {
+                    moves.emplace_back(targetPosition, die * S::DIRECTION); // Must bear off a piece
                 } else {
                     // Check to see if there are any pieces higher than the target position that can be moved
                     bool higherPieceFound = false;
-                    for (int j = i + 1; j <= 5; ++j) {
-                        if (player2[j] > 0 && player1[j - (i + 1)] <= 1) {
-                            moves.emplace_back(j, - (i + 1)); // Move a piece from a higher position
+                    for (uint32_t higher = pos.occupied[S::INDEX] & S::furtherThan(targetPosition); higher; higher &= higher - 1) {
+                        int j = __builtin_ctz(higher);
+                        if (!pos.isBlocked(S::INDEX, j + die * S::DIRECTION)) {
+                            moves.emplace_back(j, die * S::DIRECTION); // Move a piece from a higher position
                             higherPieceFound = true;
                         }
                     }
                     if (!higherPieceFound) {
                         // If no higher pieces found, bear off the next available lower piece 
-                        for (int j = targetPosition - 1; j >= 0; --j) {
-                            if (player2[j] > 0) {
-                                moves.emplace_back(j, - (i + 1)); // Bear off next available piece
-                                break; // Exit the loop after finding a piece to bear off
-                            }
+                        uint32_t lower = pos.occupied[S::INDEX] & S::closerThan(targetPosition);
+                        if (lower) {
+                            moves.emplace_back(S::furthest(lower), die * S::DIRECTION); // Bear off next available piece
                         }
                     }
 
                 }
             }
         }
-        return moves; // Return moves if bearing off is possible
+        return; // Bearing off moves are the only moves once all pieces are home
     }
 
     // Check each piece on the board for valid moves
-    for (int i = 0; i < 24; ++i) {
-        if (player2[i] > 0) { // Player 2 has pieces on this position
-            for (int j = 0; j < 6; ++j) {
-                if (dice[j] > 0) { // Check if the die is available
-                    int targetPosition = i - (j + 1); // Calculate target position
-                    if (targetPosition >= 0 && player1[targetPosition] <= 1) { // Valid move to an open point (can't bear off)
-                        moves.emplace_back(i, - (j + 1)); // Add valid move
-                    }
+    for (uint32_t from = pos.occupied[S::INDEX]; from; from &= from - 1) {
+        int i = __builtin_ctz(from); // The player has pieces on this position
+        for (int die = 1; die <= 6; ++die) {
+            if (pos.dice[die - 1] > 0) { // Check if the die is available
+                int targetPosition = i + die * S::DIRECTION; // Calculate target position
+                if (S::onBoard(targetPosition) && !pos.isBlocked(S::INDEX, targetPosition)) { // Valid move to an open point (can't bear off)
+                    moves.emplace_back(i, die * S::DIRECTION); // Add valid move
                 }
             }
         }
     }
-
-    return moves; // Return all valid moves for player 1
-}  
-
-
-void Board::handlePlayer1Move(int from, int distance) {
-    if (distance == 7) {
-        player1[from]++; // If distance is 7, it means placing a piece from the bar
-        bar1--; // Remove a piece from the bar
-        return;
-    }
-    player1[from]--; // Remove a piece from the starting position
-    int targetPosition = from + distance; // Calculate the target position
-    player1[targetPosition]++; // Place a piece in the target position
-    if (player2[targetPosition] == 1) {
-        player2[targetPosition] = 0;
-        bar2++; // If there was an opponent's piece, move it to the bar
-    }
-    dice[distance - 1]--; // Mark the die as used
 }
 
-void Board::handlePlayer2Move(int from, int distance) {
-    if (distance == 7) {
-        player2[from]++; // If distance is 7, it means placing a piece from the bar
-        bar2--; // Remove a piece from the bar
-        return;
-    }
-    player2[from]--; // Remove a piece from the starting position
-    int targetPosition = from + distance; // Calculate the target position
-    player2[targetPosition]++; // Place a piece in the target position
-    if (player1[targetPosition] == 1) {
-        player1[targetPosition] = 0;
-        bar1++; // If there was an opponent's piece, move it to the bar
-    }
-    dice[(-distance) - 1]--; // Mark the die as used (negative index for player 2)
-}
+template void Board::generateMoves<1>(MoveList& moves) const;
+template void Board::generateMoves<-1>(MoveList& moves) const;
 
 bool Board::isGameOver() const {
     // Check if either player has won the game by bearing off all their pieces
-    bool player1Won = std::all_of(player1, player1 + 24, [](uint8_t p) { return p == 0; }) && bar1 == 0;
-    bool player2Won = std::all_of(player2, player2 + 24, [](uint8_t p) { return p == 0; }) && bar2 == 0;
+    bool player1Won = pos.occupied[0] == 0 && pos.bar[0] == 0;
+    bool player2Won = pos.occupied[1] == 0 && pos.bar[1] == 0;
     
     return player1Won || player2Won;
 }
@@ -491,5 +402,5 @@ bool Board::diceAvailable(int face) const {
     if (face < 1 || face > 6) {
         throw std::out_of_range("Dice value must be between 1 and 6.");
     }
-    return this->dice[face - 1] > 0; // Check if the specified die is available
-}
\ No newline at end of file
+    return this->pos.dice[face - 1] > 0; // Check if the specified die is available
+}
@@ -3,9 +3,32 @@
 #include <inttypes.h>
 #include <vector>
 #include <numeric> // For std::accumulate
+#include <type_traits>
+#include "Position.h"
+#include "PlayTree.h"
+#include "MoveList.h"
+#include "Play.h"
+#include "Rng.h"
 
 
 
+/**
+ * @brief Compact record of a single checker move, enough to take the move back.
+ * Returned by Board::doMove and consumed by Board::undoMove.
+ */
+struct MoveUndo {
+    static constexpr uint8_t HIT = 1;      // An opponent blot was sent to the bar (opponent bar + 1)
+    static constexpr uint8_t FROM_BAR = 2; // The piece entered from the bar (own bar - 1)
+
+    int8_t from;     // Starting position of the piece (entry point for bar entries)
+    int8_t distance; // Distance moved (7 for bar entry, negative for player 2)
+    uint8_t die;     // Die face consumed by the move (1 to 6)
+    uint8_t flags;   // Combination of HIT and FROM_BAR
+};
+
+static_assert(sizeof(MoveUndo) == 4, "MoveUndo should stay 4 bytes");
+
+
 /**
  * @file Board.h
  * @brief Header file for the Board class, representing a backgammon board.
@@ -18,6 +41,9 @@
  * 
  * Player1 moves from positions 0 to 23, while Player2 moves from positions 23 to 0.
  * 
+ * The state is stored in a packed Position (see Position.h), so a Board is trivially copyable
+ * and fits in a single cache line.
+ * 
  */
 class Board {
     friend class BoardFixture; // Allow BoardFixture to access private members for testing
@@ -28,9 +54,16 @@ class Board {
          * @brief Constructs a new Board object.
          * This constructor initializes the backgammon board with two players,
          * each having 15 pieces on their respective sides. 
+         * The opening roll uses the calling thread's generator (see Rng::threadLocal).
          */
         Board();
 
+        /**
+         * @brief Constructs a new Board object in the starting position using a given generator.
+         * @param rng The generator used for the opening roll.
+         */
+        explicit Board(Rng& rng);
+
         /**
          * @brief Create a new Board object from a character array.
          * This constructor initializes the board from a character array representing the board state.
@@ -43,44 +76,57 @@ class Board {
          * 31st element is the current player. 
          */
         Board(const int boardState[31]);
+
+        /**
+         * @brief Create a new Board object from a packed position.
+         * @param position The position (checkers, bars, dice and current player) to copy.
+         */
+        explicit Board(const Position& position);
         
 
         /**
          * @brief Destroys the Board object.
-         * This destructor cleans up any resources used by the Board.
+         * The Board owns no resources, so destruction is trivial.
          */
-        ~Board();
+        ~Board() = default;
 
         /**
          * @brief Copy constructor for the Board class.
          * This constructor creates a new Board object as a copy of another Board object.
          * @param other The Board object to copy from.
-         * This method performs a deep copy of the board state, including player positions and dice values.
-         * It ensures that the new Board object has its own independent state.
+         * The board state is a single packed Position, so copying is a plain memcpy.
          */
-        Board(const Board& other);
+        Board(const Board& other) = default;
 
         /**
          * @brief Assignment operator for the Board class.
          * This operator assigns the state of one Board object to another.
          * @param other The Board object to copy from.
          * @return A reference to the current Board object.
-         * This method performs a deep copy of the board state, including player positions and dice values.
          */
-        Board& operator=(const Board& other);
+        Board& operator=(const Board& other) = default;
 
         /**
          * @brief Resets the board to its initial state.
          * This method clears the player positions and resets the dice.
+         * @param rng The generator used for the opening roll (defaults to the calling thread's generator).
          */
-        void reset();
+        void reset(Rng& rng = Rng::threadLocal());
 
         /**
          * @brief Rolls the dice for the current player and stores the results in the dice array.
          * This method generates two random numbers between 1 and 6,
          * simulating a dice roll.
+         * @param rng The generator to draw from (defaults to the calling thread's generator).
+         */
+        void rollDice(Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Sets the dice of the current player to a given roll, replacing any dice left.
+         * @param dice1 The first die (1 to 6).
+         * @param dice2 The second die (1 to 6); equal dice give 4 moves.
          */
-        void rollDice();
+        void setDice(int dice1, int dice2);
 
         /**
          * @brief Moves a player's piece from a specified position by a given distance.
@@ -88,25 +134,71 @@ class Board {
          * @param distance The number of spaces to move the piece.
          * This method updates the player's position on the board.
          * It assumes that the move is valid and does not check for game rules. 
-         * @throws std::out_of_range if the move goes out of bounds.
+         * A distance of 7 enters a piece from the bar onto position from (using the matching die),
+         * and a target beyond the edge of the board bears the piece off.
          */
         void move(int from, int distance);
 
+        /**
+         * @brief Moves a piece in place and returns what is needed to take the move back.
+         * Same as move(), intended for search: pair every doMove with an undoMove (in reverse order)
+         * instead of copying the board for each explored move.
+         * @param from The starting position of the piece to be moved.
+         * @param distance The number of spaces to move the piece.
+         * @return The undo record for the move.
+         */
+        MoveUndo doMove(int from, int distance);
+
+        /**
+         * @brief Takes back a move made with doMove.
+         * The current player must be the one who made the move, and moves must be undone in reverse order.
+         * @param undo The record returned by doMove.
+         */
+        void undoMove(const MoveUndo& undo);
+
+        /**
+         * @brief doMove for a player known at compile time (see Side.h).
+         * Used by searches that dispatch on the current player once per turn instead of once per move.
+         * @tparam Player The current player (1 or -1).
+         */
+        template <int Player>
+        MoveUndo doMove(int from, int distance);
+
+        /**
+         * @brief undoMove for a player known at compile time (see Side.h).
+         * @tparam Player The current player (1 or -1).
+         */
+        template <int Player>
+        void undoMove(const MoveUndo& undo);
+
         /**
          * @brief Moves a player's piece from a specified position by a given distance. 
          * Switches to the next player if all dice are used and rolls again. 
          * @param from The starting position of the piece to be moved.
          * @param distance The number of spaces to move the piece.
          * This method updates the player's position on the board.
+         * The legal moves of the whole turn are generated once, so checking whether the
+         * turn is over after each step is a lookup in the cached play tree.
+         * @param rng The generator used for the next player's roll (defaults to the calling thread's generator).
          */
-        void step(int from, int distance);
+        void step(int from, int distance, Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Plays a complete play and passes the turn.
+         * All checker moves are applied in one call and the next player rolls, without any legality
+         * search between the moves. The play is assumed to be one returned by legalPlays().
+         * @param play The play to make (empty when the roll cannot be played).
+         * @param rng The generator used for the next player's roll (defaults to the calling thread's generator).
+         */
+        void applyPlay(const Play& play, Rng& rng = Rng::threadLocal());
 
         /**
          * @brief Changes the current player.
          * This method switches the turn to the other player.
          * It toggles the currentPlayer variable between 1 and -1.
+         * @param rng The generator used for the new player's roll (defaults to the calling thread's generator).
          */
-        void changePlayer();
+        void changePlayer(Rng& rng = Rng::threadLocal());
 
         /**
          * @brief Gets the position of a player's piece on the board.
@@ -126,25 +218,74 @@ class Board {
         bool diceAvailable(int face) const;
 
         uint8_t diceLeft() const {
-            return std::accumulate(std::begin(dice), std::end(dice), 0); // Returns the total number of available dice
+            return std::accumulate(std::begin(pos.dice), std::end(pos.dice), 0); // Returns the total number of available dice
         }
 
         /**
          * @brief Gets the number of pieces on the bar for player 1.
          * @return The number of pieces on the bar for player 1.
          */
-        uint8_t getBar1() const { return bar1; }
+        uint8_t getBar1() const { return pos.bar[0]; }
 
         /**
          * @brief Gets the number of pieces on the bar for player 2.
          * @return The number of pieces on the bar for player 2.
          */
-        uint8_t getBar2() const { return bar2; }
+        uint8_t getBar2() const { return pos.bar[1]; }
+
+        /**
+         * @brief Gets a player's pip count, maintained incrementally by every move.
+         * @param player The player (1 or -1).
+         * @return The total number of pips the player's checkers must travel to bear off.
+         */
+        int pipCount(int player) const { return pos.pipCount(Position::sideIndex(player)); }
+
+        /**
+         * @brief Gets the number of checkers a player has borne off.
+         * @param player The player (1 or -1).
+         */
+        int checkersOff(int player) const { return pos.checkersOff(Position::sideIndex(player)); }
+
+        /**
+         * @brief Gets how far a player's rearmost checker is from bearing off.
+         * @param player The player (1 or -1).
+         * @return 25 for a checker on the bar, 1 to 24 for a checker on a point, 0 if all are borne off.
+         */
+        int highestPoint(int player) const { return pos.highestPoint(Position::sideIndex(player)); }
+
+        /**
+         * @brief Checks whether the game is a race (the players can no longer hit or block each other).
+         */
+        bool isRace() const { return !pos.hasContact(); }
+
+        /**
+         * @brief Gets the packed position backing this board.
+         * @return A const reference to the packed position.
+         */
+        const Position& position() const { return pos; }
+
+        /**
+         * @brief Writes the board in the 31 integer layout read by Board(const int boardState[31]).
+         * Points 0 to 23 (positive for player 1, negative for player 2), bar of player 1, bar of player 2,
+         * up to four dice left (-1 for no die) and the current player.
+         * @param boardState The array to fill.
+         */
+        void toArray(int boardState[31]) const;
+
+        /**
+         * @brief Gets the 64-bit Zobrist key of the board.
+         * The key covers the checkers, bars, dice and player to move and is updated incrementally
+         * by every move, so equal boards have equal keys.
+         * @return The Zobrist key.
+         */
+        uint64_t getKey() const { return pos.key; }
 
 
         /**
          * @brief Returns all valid moves for the current player. 
          * This method checks the current player's pieces and the rolled dice to determine all possible moves.
+         * Only moves that belong to a play using the most dice (and the higher die if only one can be used)
+         * are returned; see PlayTree.
          * @return A vector of pairs, where each pair contains the starting position and the distance to move.
          * Each pair represents a valid move that the current player can make.
          * The first element of the pair is the starting position of the piece,
@@ -152,6 +293,27 @@ class Board {
          */
         std::vector<std::pair<int, int>> validMoves() const;
 
+        /**
+         * @brief Writes all valid moves for the current player into a caller-provided list.
+         * Same moves as validMoves() without allocating.
+         * @param moves The list to fill (cleared first).
+         */
+        void validMoves(MoveList& moves) const;
+
+        /**
+         * @brief Returns every distinct complete play of the rest of the current turn.
+         * Orderings of the same checker moves that reach the same position are returned once, and the
+         * rules on using the most dice and the higher die are applied.
+         * @return A vector of plays; a single empty play if the roll cannot be played.
+         */
+        std::vector<Play> legalPlays() const;
+
+        /**
+         * @brief Writes every distinct complete play of the rest of the current turn into a caller-provided vector.
+         * @param plays The vector to fill (cleared first, its storage is reused).
+         */
+        void legalPlays(std::vector<Play>& plays) const;
+
          
         /**
          * @brief Returns all valid moves for player 1.
@@ -160,6 +322,13 @@ class Board {
          */
         std::vector<std::pair<int, int>> validMovesPlayer1() const;
 
+        /**
+         * @brief Writes all single die moves for player 1 into a caller-provided list.
+         * This is the allocation-free generator used by the legality search; the vector version wraps it.
+         * @param moves The list to fill (cleared first).
+         */
+        void validMovesPlayer1(MoveList& moves) const;
+
         /**
          * @brief Returns all valid moves for player 2.
          * This method checks player 2's pieces and the rolled dice to determine all possible moves.
@@ -167,6 +336,26 @@ class Board {
          */
         std::vector<std::pair<int, int>> validMovesPlayer2() const;
 
+        /**
+         * @brief Writes all single die moves for player 2 into a caller-provided list.
+         * This is the allocation-free generator used by the legality search; the vector version wraps it.
+         * @param moves The list to fill (cleared first).
+         */
+        void validMovesPlayer2(MoveList& moves) const;
+
+        /**
+         * @brief Writes all single die moves for a player known at compile time into a caller-provided list.
+         * validMovesPlayer1 and validMovesPlayer2 are this generator instantiated for 1 and -1.
+         * @tparam Player The player to generate moves for (1 or -1).
+         * @param moves The list to fill (cleared first).
+         */
+        template <int Player>
+        void generateMoves(MoveList& moves) const;
+
+        /**
+         * @brief Returns a copy of the board with a move applied.
+         * Prefer doMove/undoMove when exploring many moves from the same board.
+         */
         Board stepReturn(int from, int distance) const {
             Board newBoard(*this); // Create a copy of the current board
             newBoard.move(from, distance); // Move the piece on the copied board
@@ -195,14 +384,7 @@ class Board {
 
 
     private: 
-        uint8_t player1[24]; // Array representing player 1's pieces on the board
-        uint8_t player2[24]; // Array representing player 2's pieces on the board
-        uint8_t bar1;        // Number of pieces on the bar for player 1
-        uint8_t bar2;        // Number of pieces on the bar for player 2
-        uint8_t dice[6];     // Array representing how many dice rolls for each number (used to avoid duplicate moves) 
-                             // the player has rolled doubles, otherwise they are -1.
-        int currentPlayer;   // Variable representing the current player (1 or -1).
-        std::vector<std::pair<int, int>> moves; // Vector to store valid moves for the current player (speed up for endgame checks)
+        Position pos; // Packed checker counts, occupancy masks, bars, dice, current player and Zobrist key
 
 
     
@@ -211,42 +393,26 @@ class Board {
         ///////////////////////////////////////////////////
 
         /**
-         * @brief Returns all valid moves for player 1 using a depth-first search approach.
-         * This method checks player 1's pieces and the rolled dice to determine all possible moves.
-         * This method is used to explore all possible moves for player 1 and make sure it only returns moves
-         * that are valid according to the game rules (using moves that allow the maximum amount of dice to be used).
-         * @return A vector of pairs, where each pair contains the starting position and the distance to move. 
-         */
-        std::vector<std::pair<int, int>> validMovesDFS1() const;
-
-        /**
-         * @brief Returns all valid moves for player 2 using a depth-first search approach.
-         * This method checks player 2's pieces and the rolled dice to determine all possible moves.
-         * This method is used to explore all possible moves for player 2 and make sure it only returns moves
-         * that are valid according to the game rules (using moves that allow the maximum amount of dice to be used).
-         * @return A vector of pairs, where each pair contains the starting position and the distance to move.
+         * @brief Returns the play tree for the current turn, building it if needed.
+         * Trees are kept in a small per-thread cache indexed by Zobrist key; a cached node is
+         * only used if its position matches this board, so copies and direct modifications stay correct.
+         * @param node Set to the node of the tree matching the current state.
+         * @return The play tree.
          */
-        std::vector<std::pair<int, int>> validMovesDFS2() const;
+        const PlayTree& turnTree(uint32_t& node) const;
 
 
 
         /**
-         * @brief Handles the movement of player 1's pieces.
-         * This method updates player 1's position on the board based on the move.
-         * @param from The starting position of the piece to be moved.
-         * @param distance The number of spaces to move the piece.
+         * @brief Checks whether a player has borne off every piece and by how much they won.
+         * @tparam Player The player (1 or -1).
+         * @return 0 if the player has not won, otherwise 1, 2 or 3 (single, gammon, backgammon).
          */
-        void handlePlayer1Move(int from, int distance);
-
-
-        /**
-         * @brief Handles the movement of player 2's pieces.
-         * This method updates player 2's position on the board based on the move.
-         * @param from The starting position of the piece to be moved.
-         * @param distance The number of spaces to move the piece.
-         */
-        void handlePlayer2Move(int from, int distance);
+        template <int Player>
+        int winMargin() const;
 };
 
+static_assert(std::is_trivially_copyable<Board>::value, "Board must be trivially copyable");
+
 
 #endif // BOARD_H
\ No newline at end of file
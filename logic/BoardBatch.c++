@@ -0,0 +1,144 @@
+#include "BoardBatch.h"
+#include "OutcomeKernels.h"
+#include "Side.h"
+
+BoardBatch::BoardBatch(size_t size, Rng& rng) : games(size) {
+    for (int side = 0; side < 2; ++side) {
+        for (int point = 0; point < 24; ++point) {
+            counts[side][point].assign(games, 0);
+        }
+        bar[side].assign(games, 0);
+        occupied[side].assign(games, 0);
+        onBoard[side].assign(games, 0);
+    }
+    for (int face = 0; face < 6; ++face) {
+        dice[face].assign(games, 0);
+    }
+    currentPlayer.assign(games, 1);
+    for (size_t game = 0; game < games; ++game) {
+        reset(game, rng);
+    }
+}
+
+void BoardBatch::reset(size_t game, Rng& rng) {
+    set(game, Board(rng)); // Same opening setup and roll as a fresh Board
+}
+
+Board BoardBatch::get(size_t game) const {
+    Position pos;
+    pos.clear();
+    for (int side = 0; side < 2; ++side) {
+        for (int point = 0; point < 24; ++point) {
+            if (counts[side][point][game] != 0) {
+                pos.setCount(side, point, counts[side][point][game]);
+            }
+        }
+        pos.setBar(side, bar[side][game]);
+    }
+    for (int face = 1; face <= 6; ++face) {
+        pos.setDice(face, dice[face - 1][game]);
+    }
+    pos.setCurrentPlayer(currentPlayer[game]);
+    return Board(pos);
+}
+
+void BoardBatch::set(size_t game, const Board& board) {
+    const Position& pos = board.position();
+    for (int side = 0; side < 2; ++side) {
+        for (int point = 0; point < 24; ++point) {
+            counts[side][point][game] = pos.count(side, point);
+        }
+        bar[side][game] = pos.bar[side];
+        occupied[side][game] = pos.occupied[side];
+        onBoard[side][game] = (uint8_t)pos.checkersOnBoard(side);
+    }
+    for (int face = 0; face < 6; ++face) {
+        dice[face][game] = pos.dice[face];
+    }
+    currentPlayer[game] = pos.currentPlayer;
+}
+
+void BoardBatch::rollDice(size_t game, Rng& rng) {
+    for (int face = 0; face < 6; ++face) {
+        dice[face][game] = 0;
+    }
+    int roll = (int)rng.below(36); // Same single draw as Board::rollDice
+    int dice1 = roll / 6;
+    int dice2 = roll % 6;
+    if (dice1 == dice2) {
+        dice[dice1][game] = 4; // 4 available moves for doubles
+    } else {
+        dice[dice1][game] = 1;
+        dice[dice2][game] = 1;
+    }
+}
+
+void BoardBatch::rollDiceAll(Rng& rng) {
+    for (size_t game = 0; game < games; ++game) {
+        rollDice(game, rng);
+    }
+}
+
+void BoardBatch::legalPlaysAll(std::vector<std::vector<Play>>& plays) const {
+    std::vector<int8_t> outcomes;
+    outcomeAll(outcomes);
+    plays.resize(games);
+    for (size_t game = 0; game < games; ++game) {
+        if (outcomes[game] != 0) {
+            plays[game].clear(); // Nothing left to play
+        } else {
+            get(game).legalPlays(plays[game]);
+        }
+    }
+}
+
+template <int Player>
+void BoardBatch::applyPlay(size_t game, const Play& play) {
+    using S = Side<Player>;
+    for (const Move& m : play) {
+        int targetPosition;
+        if (m.distance == 7) {
+            bar[S::INDEX][game]--; // Enter a piece from the bar
+            onBoard[S::INDEX][game]++;
+            targetPosition = m.from;
+        } else {
+            if (--counts[S::INDEX][m.from][game] == 0) {
+                occupied[S::INDEX][game] &= ~(1u << m.from);
+            }
+            targetPosition = m.from + m.distance;
+        }
+        if (S::onBoard(targetPosition)) {
+            counts[S::INDEX][targetPosition][game]++;
+            occupied[S::INDEX][game] |= 1u << targetPosition;
+            if (counts[S::OPPONENT][targetPosition][game] == 1) {
+                counts[S::OPPONENT][targetPosition][game] = 0; // Hit the blot
+                occupied[S::OPPONENT][game] &= ~(1u << targetPosition);
+                onBoard[S::OPPONENT][game]--;
+                bar[S::OPPONENT][game]++;
+            }
+        } else {
+            onBoard[S::INDEX][game]--; // The piece is borne off
+        }
+    }
+}
+
+void BoardBatch::applyAll(const std::vector<Play>& plays, Rng& rng) {
+    std::vector<int8_t> outcomes;
+    outcomeAll(outcomes);
+    for (size_t game = 0; game < games; ++game) {
+        if (outcomes[game] != 0) {
+            continue; // Finished games are left as they are
+        }
+        (currentPlayer[game] == 1) ? applyPlay<1>(game, plays[game]) : applyPlay<-1>(game, plays[game]);
+        currentPlayer[game] = (currentPlayer[game] == 1) ? -1 : 1;
+        rollDice(game, rng); // The dice left of the play are discarded by the new roll
+    }
+}
+
+void BoardBatch::outcomeAll(std::vector<int8_t>& outcomes) const {
+    outcomes.resize(games);
+    const OutcomeInputs in = {{occupied[0].data(), occupied[1].data()},
+                              {onBoard[0].data(), onBoard[1].data()},
+                              {bar[0].data(), bar[1].data()}};
+    outcomeKernel()(in, outcomes.data(), games); // SSE2 or AVX2 depending on the CPU
+}
@@ -0,0 +1,113 @@
+#ifndef BOARDBATCH_H
+#define BOARDBATCH_H
+#include <inttypes.h>
+#include <cstddef>
+#include <vector>
+#include "Board.h"
+#include "Play.h"
+#include "Rng.h"
+
+
+
+/**
+ * @file BoardBatch.h
+ * @brief Many independent games stored in struct-of-arrays layout and advanced in lockstep.
+ *
+ * Every field of the board is stored as one array with an entry per game: counts[side][point]
+ * holds the checker count of that point for every game, next to each other, and the bars, dice
+ * and player to move are stored the same way. Like Position, each game also keeps occupancy
+ * masks and the number of checkers on the board per side, so whole-batch passes such as
+ * outcomeAll are a single pass over contiguous arrays, done with SIMD kernels (see OutcomeKernels.h).
+ *
+ * The legality search itself is per game: legalPlaysAll gathers each game into a Board and runs
+ * the usual play tree search, while applyAll writes the chosen plays straight into the arrays.
+ * Games are played with the same rules and random number consumption as Board, so a batch and
+ * a set of Boards driven by the same generator stay identical.
+ */
+class BoardBatch {
+    public:
+
+        /**
+         * @brief Starts a batch of games from the opening position.
+         * Each game rolls for the first player exactly like Board::reset, in game order.
+         * @param size The number of games.
+         * @param rng The generator used for the opening rolls (defaults to the calling thread's generator).
+         */
+        explicit BoardBatch(size_t size, Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Gets the number of games in the batch.
+         */
+        size_t size() const { return games; }
+
+        /**
+         * @brief Restarts one game from the opening position.
+         * @param game The game index.
+         * @param rng The generator used for the opening roll.
+         */
+        void reset(size_t game, Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Copies a game out of the batch.
+         * @param game The game index.
+         * @return A Board holding the game's position, dice and player to move.
+         */
+        Board get(size_t game) const;
+
+        /**
+         * @brief Overwrites a game of the batch with a board.
+         * @param game The game index.
+         * @param board The board to copy in.
+         */
+        void set(size_t game, const Board& board);
+
+        /**
+         * @brief Rolls new dice for the player to move in every game.
+         * @param rng The generator used for the rolls, consumed in game order.
+         */
+        void rollDiceAll(Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Generates the distinct complete plays of every game.
+         * @param plays Resized to the batch size; plays[i] is filled like Board::legalPlays for game i,
+         * and left empty if game i is over.
+         */
+        void legalPlaysAll(std::vector<std::vector<Play>>& plays) const;
+
+        /**
+         * @brief Plays one play in every game that is not over, then passes the turn and rolls.
+         * @param plays One play per game (ignored for games that are over). Plays are assumed legal.
+         * @param rng The generator used for the next rolls, consumed in game order.
+         */
+        void applyAll(const std::vector<Play>& plays, Rng& rng = Rng::threadLocal());
+
+        /**
+         * @brief Computes the outcome of every game, as Board::getOutcome.
+         * @param outcomes Resized to the batch size; 0 for games still going on, otherwise
+         * +-1, +-2 or +-3 for a single, gammon or backgammon win of player 1 (+) or player 2 (-).
+         */
+        void outcomeAll(std::vector<int8_t>& outcomes) const;
+
+    private:
+        size_t games;
+        std::vector<uint8_t> counts[2][24];  // Checker counts per side and point, one entry per game
+        std::vector<uint8_t> bar[2];         // Checkers on the bar per side, one entry per game
+        std::vector<uint8_t> dice[6];        // Dice left per face, one entry per game
+        std::vector<int8_t> currentPlayer;   // Player to move (1 or -1), one entry per game
+        std::vector<uint32_t> occupied[2];   // Bit i set if the side has a checker on point i, one entry per game
+        std::vector<uint8_t> onBoard[2];     // Checkers on the points per side (bar excluded), one entry per game
+
+        /**
+         * @brief Rolls the dice of one game (same draws as Board::rollDice).
+         */
+        void rollDice(size_t game, Rng& rng);
+
+        /**
+         * @brief Applies a play for a player known at compile time to one game (see Side.h).
+         */
+        template <int Player>
+        void applyPlay(size_t game, const Play& play);
+};
+
+
+#endif // BOARDBATCH_H
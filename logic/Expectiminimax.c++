@@ -0,0 +1,277 @@
+#include "Expectiminimax.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+struct Roll {
+    int high;
+    int low;
+    float probability;
+};
+
+// The 21 distinct rolls, the 15 non-doubles (2/36) before the 6 doubles (1/36)
+struct RollOrder {
+    Roll rolls[21];
+
+    RollOrder() {
+        int i = 0;
+        for (int h = 2; h <= 6; ++h) {
+            for (int l = 1; l < h; ++l) {
+                rolls[i++] = Roll{h, l, 2.0f / 36.0f};
+            }
+        }
+        for (int d = 1; d <= 6; ++d) {
+            rolls[i++] = Roll{d, d, 1.0f / 36.0f};
+        }
+    }
+};
+
+const RollOrder ROLL_ORDER;
+
+const float INF = INFINITY;
+
+// Results at different depths are different entries of the table
+inline uint64_t tableKey(uint64_t key, int depth) {
+    return key ^ (0x9e3779b97f4a7c15ull * (uint64_t)(depth + 1));
+}
+
+} // namespace
+
+Expectiminimax::Expectiminimax(Evaluator evaluator) : Expectiminimax(evaluator, Options()) {}
+
+Expectiminimax::Expectiminimax(Evaluator evaluator, const Options& options) : evaluator(evaluator), options(options) {}
+
+Board Expectiminimax::afterPlay(const Board& board, const Play& play) {
+    Board after(board);
+    for (const Move& m : play) {
+        after.move(m.from, m.distance);
+    }
+    Position position = after.position();
+    for (int face = 1; face <= 6; ++face) {
+        position.setDice(face, 0);
+    }
+    position.setCurrentPlayer(-board.getCurrentPlayer());
+    return Board(position);
+}
+
+Expectiminimax::MoveOrdering Expectiminimax::staticOrdering(Evaluator evaluator) {
+    return [evaluator](const Board& board, const std::vector<Play>& plays, float* scores) {
+        for (size_t i = 0; i < plays.size(); ++i) {
+            const Board after = afterPlay(board, plays[i]);
+            scores[i] = after.isGameOver() ? (float)(after.getOutcome() * board.getCurrentPlayer()) : -evaluator(after);
+        }
+    };
+}
+
+float Expectiminimax::search(const Board& board, int depth, Play& best) {
+    level = 0;
+    frames.resize(std::max(frames.size(), (size_t)depth + 2));
+    const uint64_t key = tableKey(board.getKey(), depth + 1);
+    float value;
+    uint16_t bestPlay = TranspositionTable::NO_PLAY;
+    if (probe(key, depth + 1, -INF, INF, value, bestPlay) && bestPlay != TranspositionTable::NO_PLAY) {
+        board.legalPlays(frames[0].plays);
+        if (bestPlay < frames[0].plays.size()) {
+            best = frames[0].plays[bestPlay];
+            return value;
+        }
+    }
+    counters.decisionNodes++;
+    Frame& frame = orderedPlays(board, bestPlay);
+    ++level;
+    float alpha = -INF;
+    uint16_t bestIndex = frame.order[0];
+    for (uint16_t k : frame.order) {
+        const float v = playValue(board, frame.plays[k], depth, alpha, INF);
+        if (v > alpha) {
+            alpha = v;
+            bestIndex = k;
+        }
+    }
+    --level;
+    store(key, depth + 1, -INF, INF, alpha, bestIndex);
+    best = frame.plays[bestIndex];
+    return alpha;
+}
+
+float Expectiminimax::evaluatePlay(const Board& board, const Play& play, int depth) {
+    level = 0;
+    frames.resize(std::max(frames.size(), (size_t)depth + 1));
+    return playValue(board, play, depth, -INF, INF);
+}
+
+float Expectiminimax::evaluatePosition(const Board& board, int depth) {
+    if (board.isGameOver()) {
+        return (float)(board.getOutcome() * board.getCurrentPlayer());
+    }
+    level = 0;
+    frames.resize(std::max(frames.size(), (size_t)depth + 1));
+    return chance(board, depth, -INF, INF);
+}
+
+float Expectiminimax::playValue(const Board& board, const Play& play, int depth, float alpha, float beta) {
+    const Board after = afterPlay(board, play);
+    if (after.isGameOver()) {
+        return (float)(after.getOutcome() * board.getCurrentPlayer());
+    }
+    return -chance(after, depth, -beta, -alpha);
+}
+
+float Expectiminimax::chance(const Board& board, int depth, float alpha, float beta) {
+    if (depth == 0) {
+        return staticValue(board);
+    }
+    counters.chanceNodes++;
+    const uint64_t key = tableKey(board.getKey(), depth);
+    float value;
+    uint16_t unused;
+    if (probe(key, depth, alpha, beta, value, unused)) {
+        return value;
+    }
+    const float lowest = options.minEquity;
+    const float highest = options.maxEquity;
+    float lower[21]; // Lower bound of every roll's value
+    std::fill(lower, lower + 21, lowest);
+    float lowerSum = lowest; // Sum of the lower bounds weighted by the roll probabilities
+    Board rolled(board);
+
+    // Star2: a single play of each roll bounds its value from below. Pointless when beta is out of reach.
+    if (options.star2 && beta < highest) {
+        for (int i = 0; i < 21; ++i) {
+            const Roll& roll = ROLL_ORDER.rolls[i];
+            rolled.setDice(roll.high, roll.low);
+            const float cut = (beta - (lowerSum - roll.probability * lowest)) / roll.probability;
+            lower[i] = decision(rolled, depth, lowest, std::min(cut, highest), true);
+            lowerSum += roll.probability * (lower[i] - lowest);
+            if (lowerSum >= beta) {
+                counters.star2Cutoffs++;
+                store(key, depth, alpha, beta, lowerSum, TranspositionTable::NO_PLAY);
+                return lowerSum;
+            }
+        }
+    }
+
+    // Star1: each roll is searched with the window outside which the node is known to fail
+    float sum = 0.0f;       // Weighted values of the rolls searched
+    float left = 1.0f;      // Probability of the rolls not searched yet
+    float lowerLeft = lowerSum; // Weighted lower bounds of the rolls not searched yet
+    for (int i = 0; i < 21; ++i) {
+        const Roll& roll = ROLL_ORDER.rolls[i];
+        const float p = roll.probability;
+        lowerLeft -= p * lower[i];
+        const float failLow = (alpha - sum - (left - p) * highest) / p;
+        const float failHigh = (beta - sum - lowerLeft) / p;
+        rolled.setDice(roll.high, roll.low);
+        const float v = decision(rolled, depth, std::max(failLow, lowest), std::min(failHigh, highest), false);
+        if (v <= failLow) {
+            value = sum + p * v + (left - p) * highest; // An upper bound, at most alpha
+            counters.star1Cutoffs++;
+            store(key, depth, alpha, beta, value, TranspositionTable::NO_PLAY);
+            return value;
+        }
+        if (v >= failHigh) {
+            value = sum + p * v + lowerLeft; // A lower bound, at least beta
+            counters.star1Cutoffs++;
+            store(key, depth, alpha, beta, value, TranspositionTable::NO_PLAY);
+            return value;
+        }
+        sum += p * v;
+        left -= p;
+    }
+    store(key, depth, alpha, beta, sum, TranspositionTable::NO_PLAY);
+    return sum;
+}
+
+float Expectiminimax::decision(const Board& board, int depth, float alpha, float beta, bool firstPlayOnly) {
+    counters.decisionNodes++;
+    const uint64_t key = tableKey(board.getKey(), depth);
+    float value;
+    uint16_t bestPlay = TranspositionTable::NO_PLAY;
+    if (probe(key, depth, alpha, beta, value, bestPlay)) {
+        return value;
+    }
+    Frame& frame = orderedPlays(board, bestPlay);
+    ++level;
+    float best = -INF;
+    uint16_t bestIndex = frame.order[0];
+    float a = alpha;
+    for (uint16_t k : frame.order) {
+        const float v = playValue(board, frame.plays[k], depth - 1, a, beta);
+        if (v > best) {
+            best = v;
+            bestIndex = k;
+        }
+        a = std::max(a, best);
+        if (a >= beta || firstPlayOnly) {
+            break;
+        }
+    }
+    --level;
+    if (!firstPlayOnly) {
+        store(key, depth, alpha, beta, best, bestIndex);
+    }
+    return best;
+}
+
+Expectiminimax::Frame& Expectiminimax::orderedPlays(const Board& board, uint16_t bestPlay) {
+    Frame& frame = frames[level];
+    board.legalPlays(frame.plays);
+    const size_t n = frame.plays.size();
+    frame.order.resize(n);
+    std::iota(frame.order.begin(), frame.order.end(), (uint16_t)0);
+    if (options.ordering && n > 1) {
+        frame.scores.assign(n, 0.0f);
+        options.ordering(board, frame.plays, frame.scores.data());
+        const std::vector<float>& scores = frame.scores;
+        std::stable_sort(frame.order.begin(), frame.order.end(), [&scores](uint16_t a, uint16_t b) { return scores[a] > scores[b]; });
+    }
+    if (bestPlay < n) {
+        const auto it = std::find(frame.order.begin(), frame.order.end(), bestPlay);
+        std::rotate(frame.order.begin(), it, it + 1);
+    }
+    return frame;
+}
+
+float Expectiminimax::staticValue(const Board& board) {
+    const uint64_t key = tableKey(board.getKey(), 0);
+    float value;
+    uint16_t unused;
+    if (probe(key, 0, -INF, INF, value, unused)) {
+        return value;
+    }
+    counters.evaluations++;
+    value = std::min(std::max(evaluator(board), options.minEquity), options.maxEquity);
+    store(key, 0, -INF, INF, value, TranspositionTable::NO_PLAY);
+    return value;
+}
+
+bool Expectiminimax::probe(uint64_t key, int depth, float alpha, float beta, float& value, uint16_t& bestPlay) {
+    TranspositionTable::Entry entry;
+    if (options.table == nullptr || !options.table->probe(key, entry) || entry.depth != depth) {
+        return false;
+    }
+    bestPlay = entry.bestPlay;
+    if (entry.bound == TranspositionTable::Bound::EXACT
+        || (entry.bound == TranspositionTable::Bound::LOWER && entry.equity >= beta)
+        || (entry.bound == TranspositionTable::Bound::UPPER && entry.equity <= alpha)) {
+        value = entry.equity;
+        counters.tableHits++;
+        return true;
+    }
+    return false;
+}
+
+void Expectiminimax::store(uint64_t key, int depth, float alpha, float beta, float value, uint16_t bestPlay) {
+    if (options.table == nullptr) {
+        return;
+    }
+    TranspositionTable::Bound bound = TranspositionTable::Bound::EXACT;
+    if (value <= alpha) {
+        bound = TranspositionTable::Bound::UPPER;
+    } else if (value >= beta) {
+        bound = TranspositionTable::Bound::LOWER;
+    }
+    options.table->store(key, TranspositionTable::Entry{value, (uint8_t)depth, bound, bestPlay});
+}
@@ -0,0 +1,163 @@
+#ifndef EXPECTIMINIMAX_H
+#define EXPECTIMINIMAX_H
+#include <inttypes.h>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "Board.h"
+#include "Play.h"
+#include "TranspositionTable.h"
+
+
+
+/**
+ * @file Expectiminimax.h
+ * @brief n-ply expectiminimax search with Star1 and Star2 pruning at the chance nodes.
+ *
+ * Depths count rolls, as in GNU Backgammon: a play is scored at 0-ply by the static evaluator of the
+ * position it reaches, and at n-ply by the mean over the opponent's 21 rolls of the opponent's best
+ * reply scored at (n-1)-ply. A chance node is a position whose player on roll has not rolled yet,
+ * and its children are the decision nodes of the 21 rolls.
+ *
+ * Decision nodes are searched with alpha-beta. Chance nodes use Ballard's bounds, which need the
+ * equities to lie between minEquity and maxEquity:
+ *  - Star1: once some rolls are searched, the rolls left can only move the mean between their worst
+ *    and best cases, so each roll is searched with the narrowest window that can still change the
+ *    result, and the node is cut off as soon as the mean is known to fall outside the window.
+ *  - Star2: before the full search, every roll is probed with its first play only (per the move
+ *    ordering). A single play gives a lower bound on the player's best play, and the probes together
+ *    often prove that the node fails high without searching the other plays. The lower bounds also
+ *    tighten the Star1 windows of the full search.
+ * Rolls are visited in order of probability (non-doubles first), so that the rolls that move the
+ * bounds the most come first.
+ *
+ * With a TranspositionTable, static evaluations, chance nodes and decision nodes are cached by
+ * Zobrist key and depth, and the best play of a decision node is tried first when it is searched
+ * again. The move ordering hook scores the plays of a decision node, and plays are searched from the
+ * highest score down.
+ *
+ * Equities are in points for the player on roll (+1, +2, +3 for a single, gammon or backgammon
+ * win) and are cubeless.
+ */
+class Expectiminimax {
+    public:
+        /**
+         * @brief Scores a chance node statically.
+         * @param board The board, with the player on roll not having rolled yet (no dice left).
+         * @return The equity of the player on roll, between minEquity and maxEquity.
+         */
+        typedef std::function<float(const Board& board)> Evaluator;
+
+        /**
+         * @brief Scores the plays of a decision node for move ordering: higher scores are searched first.
+         * @param board The board, with the dice rolled.
+         * @param plays The legal plays.
+         * @param scores Receives one score per play.
+         */
+        typedef std::function<void(const Board& board, const std::vector<Play>& plays, float* scores)> MoveOrdering;
+
+        struct Options {
+            float minEquity = -3.0f;              // Lowest equity the evaluator and game results can give
+            float maxEquity = 3.0f;               // Highest equity
+            bool star2 = true;                    // Probe the rolls before searching them (Star1 is always on)
+            TranspositionTable* table = nullptr;  // Cache shared with other searches, or none
+            MoveOrdering ordering;                // Plays in generation order when empty
+        };
+
+        struct Stats {
+            uint64_t decisionNodes = 0;
+            uint64_t chanceNodes = 0;
+            uint64_t evaluations = 0;  // Evaluator calls
+            uint64_t star1Cutoffs = 0; // Chance nodes cut off during the full search
+            uint64_t star2Cutoffs = 0; // Chance nodes cut off by the probes
+            uint64_t tableHits = 0;    // Nodes and evaluations answered by the table
+        };
+
+        explicit Expectiminimax(Evaluator evaluator);
+        Expectiminimax(Evaluator evaluator, const Options& options);
+
+        /**
+         * @brief Finds the best play of a position.
+         * @param board The board, with the dice rolled.
+         * @param depth The depth in rolls (0 scores every play statically).
+         * @param best Set to the best play.
+         * @return The equity of the best play for the player on roll.
+         */
+        float search(const Board& board, int depth, Play& best);
+
+        /**
+         * @brief Scores one play exactly.
+         * @param board The board, with the dice rolled.
+         * @param play A legal play.
+         * @param depth The depth in rolls.
+         * @return The equity of the play for the player making it.
+         */
+        float evaluatePlay(const Board& board, const Play& play, int depth);
+
+        /**
+         * @brief Scores a chance node exactly.
+         * @param board The board, with the player on roll not having rolled yet.
+         * @param depth The depth in rolls (0 for the static evaluation).
+         * @return The equity of the player on roll.
+         */
+        float evaluatePosition(const Board& board, int depth);
+
+        const Stats& stats() const { return counters; }
+
+        void resetStats() { counters = Stats(); }
+
+        /**
+         * @brief Gets the board reached by a play, with the other player on roll and no dice rolled.
+         */
+        static Board afterPlay(const Board& board, const Play& play);
+
+        /**
+         * @brief Move ordering by the static evaluation of the position every play reaches.
+         */
+        static MoveOrdering staticOrdering(Evaluator evaluator);
+
+    private:
+        Evaluator evaluator;
+        Options options;
+        Stats counters;
+
+        // Per decision node on the current path: its plays in generation order and the search order
+        struct Frame {
+            std::vector<Play> plays;
+            std::vector<float> scores;
+            std::vector<uint16_t> order;
+        };
+        std::vector<Frame> frames;
+        size_t level = 0; // Decision nodes on the current path
+
+        /**
+         * @brief Gets the equity of a play for the player making it, searched with a window.
+         */
+        float playValue(const Board& board, const Play& play, int depth, float alpha, float beta);
+
+        /**
+         * @brief Searches a chance node with a window (fail-soft).
+         */
+        float chance(const Board& board, int depth, float alpha, float beta);
+
+        /**
+         * @brief Searches a decision node with a window (fail-soft).
+         * @param firstPlayOnly Only searches the first play, which gives a lower bound (the Star2 probe).
+         */
+        float decision(const Board& board, int depth, float alpha, float beta, bool firstPlayOnly);
+
+        /**
+         * @brief Generates and orders the plays of a decision node into the frame of the current level.
+         * @param bestPlay Index of the play to try first (from the table), or TranspositionTable::NO_PLAY.
+         */
+        Frame& orderedPlays(const Board& board, uint16_t bestPlay);
+
+        float staticValue(const Board& board);
+
+        bool probe(uint64_t key, int depth, float alpha, float beta, float& value, uint16_t& bestPlay);
+
+        void store(uint64_t key, int depth, float alpha, float beta, float value, uint16_t bestPlay);
+};
+
+
+#endif // EXPECTIMINIMAX_H
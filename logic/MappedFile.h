@@ -0,0 +1,69 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <inttypes.h>
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+/**
+ * @file MappedFile.h
+ * @brief A read-only memory mapping of a whole file, used by the endgame databases.
+ *
+ * The pages are loaded on first access and shared between every process mapping the same file,
+ * so a database is usable right after open() without reading or deserializing it.
+ */
+class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Maps a file read-only, unmapping the previous one.
+         * @return false if the file is missing or empty.
+         */
+        bool open(const std::string& path) {
+            close();
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0 || info.st_size == 0) {
+                ::close(fd);
+                return false;
+            }
+            void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd); // The mapping keeps the file alive
+            if (mapped == MAP_FAILED) {
+                return false;
+            }
+            bytes = (const uint8_t*)mapped;
+            length = (size_t)info.st_size;
+            return true;
+        }
+
+        void close() {
+            if (bytes != nullptr) {
+                munmap((void*)bytes, length);
+                bytes = nullptr;
+                length = 0;
+            }
+        }
+
+        const uint8_t* data() const { return bytes; }
+        size_t size() const { return length; }
+
+    private:
+        const uint8_t* bytes = nullptr;
+        size_t length = 0;
+};
+
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,444 @@
+#include "Mcts.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <thread>
+
+namespace {
+
+// The 21 distinct rolls (higher die first) and their weights in 36ths
+struct Rolls {
+    int high[Mcts::ROLLS];
+    int low[Mcts::ROLLS];
+    int weight[Mcts::ROLLS];
+
+    Rolls() {
+        int roll = 0;
+        for (int h = 1; h <= 6; ++h) {
+            for (int l = 1; l <= h; ++l, ++roll) {
+                high[roll] = h;
+                low[roll] = l;
+                weight[roll] = (h == l) ? 1 : 2;
+            }
+        }
+    }
+};
+
+const Rolls ROLL_TABLE;
+
+// Value sums are fixed point so that threads can add to them atomically
+const double VALUE_SCALE = 1048576.0;
+
+inline int64_t toFixed(double value) {
+    return (int64_t)std::llround(value * VALUE_SCALE);
+}
+
+// Atomic access to the node fields shared between threads (the nodes themselves are plain structs)
+template <typename T>
+inline T load(const T& field) {
+    return __atomic_load_n(&field, __ATOMIC_RELAXED);
+}
+
+template <typename T>
+inline T acquire(const T& field) {
+    return __atomic_load_n(&field, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+inline void release(T& field, T value) {
+    __atomic_store_n(&field, value, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+inline void add(T& field, T delta) {
+    __atomic_fetch_add(&field, delta, __ATOMIC_RELAXED);
+}
+
+template <typename T>
+inline void subtract(T& field, T delta) {
+    __atomic_fetch_sub(&field, delta, __ATOMIC_RELAXED);
+}
+
+template <typename T>
+inline bool claim(T& field, T expected, T desired) {
+    return __atomic_compare_exchange_n(&field, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+int threadCount(int requested) {
+    const int threads = requested > 0 ? requested : (int)std::thread::hardware_concurrency();
+    return std::max(threads, 1);
+}
+
+} // namespace
+
+Mcts::Mcts(Evaluator evaluator) : Mcts(evaluator, Options()) {}
+
+Mcts::Mcts(Evaluator evaluator, const Options& options) : evaluator(evaluator), options(options) {}
+
+Mcts::~Mcts() {}
+
+void Mcts::clear() {
+    decisions.reset();
+    edges.reset();
+    chances.reset();
+    plays.clear();
+    collisionCount = 0;
+    for (std::unique_ptr<Mcts>& helper : helpers) {
+        helper->clear();
+    }
+}
+
+bool Mcts::start(const Board& root, uint64_t seed) {
+    clear();
+    if (workers.empty()) {
+        workers.emplace_back(new Worker(*this));
+    }
+    Worker& worker = *workers[0];
+    worker.rng.seed(seed);
+    worker.path.clear();
+    const uint32_t node = worker.decisions.allocate(1);
+    if (node == NONE) {
+        return false;
+    }
+    new (&decisions[node]) DecisionNode{root, 0, NONE, 0};
+    float value;
+    if (!expand(worker, node, value)) {
+        return false;
+    }
+    decisions[node].visits = 1;
+    for (uint32_t i = 0; i < decisions[node].edgeCount; ++i) {
+        plays.push_back(edges[decisions[node].firstEdge + i].play);
+    }
+    return true;
+}
+
+void Mcts::search(const Board& root) {
+    const int threads = threadCount(options.threads);
+    if (threads > 1 && options.parallelism == Parallelism::ROOT) {
+        searchRootParallel(root, threads);
+        return;
+    }
+    if (!start(root, options.seed)) {
+        return;
+    }
+    virtualLoss = threads > 1 ? toFixed(options.virtualLoss) : 0;
+    std::atomic<int64_t> remaining((int64_t)options.iterations);
+    if (threads == 1) {
+        run(*workers[0], remaining);
+    } else {
+        while (workers.size() < (size_t)threads) {
+            workers.emplace_back(new Worker(*this));
+        }
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) {
+            Worker& worker = *workers[i];
+            worker.rng.seed(options.seed + (uint64_t)i);
+            worker.collisions = 0;
+            pool.emplace_back([this, &worker, &remaining] { run(worker, remaining); });
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+        for (int i = 0; i < threads; ++i) {
+            collisionCount += workers[i]->collisions;
+        }
+    }
+}
+
+void Mcts::searchRootParallel(const Board& root, int threads) {
+    // Each tree gets an equal share of the iterations; this tree searches with the first share
+    Options single(options);
+    single.threads = 1;
+    while (helpers.size() < (size_t)threads - 1) {
+        helpers.emplace_back(new Mcts(evaluator, single));
+    }
+    for (int i = 1; i < threads; ++i) {
+        Mcts& helper = *helpers[i - 1];
+        helper.evaluator = evaluator;
+        helper.options = single;
+        helper.options.seed = options.seed + (uint64_t)i;
+        helper.options.iterations = options.iterations / threads + ((uint32_t)i < options.iterations % threads ? 1 : 0);
+    }
+    if (!start(root, options.seed)) {
+        return;
+    }
+    virtualLoss = 0;
+    std::atomic<int64_t> remaining((int64_t)(options.iterations / threads + (options.iterations % threads ? 1 : 0)));
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) {
+        Mcts* helper = helpers[i - 1].get();
+        pool.emplace_back([helper, &root] { helper->search(root); });
+    }
+    run(*workers[0], remaining);
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    // The root plays come from the same board, so the edges of every tree are in the same order
+    DecisionNode& node = decisions[0];
+    for (int i = 1; i < threads; ++i) {
+        const Mcts& helper = *helpers[i - 1];
+        if (helper.plays.size() != plays.size()) {
+            continue; // Its arenas were full before the root was expanded
+        }
+        const DecisionNode& other = helper.decisions[0];
+        for (uint32_t e = 0; e < node.edgeCount; ++e) {
+            edges[node.firstEdge + e].visits += helper.edges[other.firstEdge + e].visits;
+            edges[node.firstEdge + e].valueSum += helper.edges[other.firstEdge + e].valueSum;
+        }
+        node.visits += other.visits - 1;
+    }
+}
+
+void Mcts::run(Worker& worker, std::atomic<int64_t>& remaining) {
+    while (remaining.fetch_sub(1, std::memory_order_relaxed) > 0) {
+        if (!simulate(worker)) {
+            remaining.store(0, std::memory_order_relaxed); // The arenas are full: every thread stops
+            return;
+        }
+    }
+}
+
+bool Mcts::expand(Worker& worker, uint32_t node, float& value) {
+    DecisionNode& decision = decisions[node];
+    const Board& board = decision.board;
+    board.legalPlays(worker.scratch);
+    const uint32_t first = worker.edges.allocate((uint32_t)worker.scratch.size());
+    if (first == NONE) {
+        return false;
+    }
+    worker.priors.assign(worker.scratch.size(), 0.0f);
+    value = evaluator(board, worker.scratch, worker.priors.data(), worker.rng);
+
+    float total = 0.0f;
+    for (float p : worker.priors) {
+        total += (p > 0.0f) ? p : 0.0f;
+    }
+    for (size_t i = 0; i < worker.scratch.size(); ++i) {
+        const float prior = (total > 0.0f) ? std::max(worker.priors[i], 0.0f) / total : 1.0f / (float)worker.scratch.size();
+        new (&edges[first + (uint32_t)i]) Edge{worker.scratch[i], prior, 0, NONE, 0};
+    }
+    decision.edgeCount = (uint32_t)worker.scratch.size();
+    release(decision.firstEdge, first); // Publishes the edges to the other threads
+    return true;
+}
+
+float Mcts::evaluate(Worker& worker, uint32_t node) {
+    const Board& board = decisions[node].board;
+    board.legalPlays(worker.scratch);
+    worker.priors.assign(worker.scratch.size(), 0.0f);
+    return evaluator(board, worker.scratch, worker.priors.data(), worker.rng);
+}
+
+bool Mcts::createChance(Worker& worker, uint32_t node, uint32_t edge) {
+    const uint32_t chance = worker.chances.allocate(1);
+    if (chance == NONE) {
+        return false;
+    }
+    // The dice of each child are set below, so the play is applied without rolling: drawing dice here
+    // would spend the worker's Rng on rolls that are thrown away
+    Board played(decisions[node].board);
+    for (const Move& m : edges[edge].play) {
+        played.move(m.from, m.distance);
+    }
+    Position position = played.position();
+    position.setCurrentPlayer(-position.currentPlayer);
+    Board after(position);
+    if (after.isGameOver()) {
+        const float outcome = (float)(after.getOutcome() * decisions[node].board.getCurrentPlayer());
+        new (&chances[chance]) ChanceNode{NONE, 0, outcome, true};
+    } else {
+        const uint32_t first = worker.decisions.allocate(ROLLS);
+        if (first == NONE) {
+            return false;
+        }
+        for (int r = 0; r < ROLLS; ++r) {
+            after.setDice(ROLL_TABLE.high[r], ROLL_TABLE.low[r]);
+            new (&decisions[first + r]) DecisionNode{after, 0, NONE, 0};
+        }
+        new (&chances[chance]) ChanceNode{first, 0, 0.0f, false};
+    }
+    release(edges[edge].chance, chance);
+    return true;
+}
+
+uint32_t Mcts::select(const DecisionNode& node, uint32_t firstEdge) const {
+    const float scale = options.exploration * std::sqrt((float)load(node.visits));
+    uint32_t best = firstEdge;
+    float bestScore = -1e30f;
+    for (uint32_t i = firstEdge; i < firstEdge + node.edgeCount; ++i) {
+        const Edge& edge = edges[i];
+        const uint32_t visits = load(edge.visits);
+        const float q = visits ? (float)((double)load(edge.valueSum) / VALUE_SCALE / visits) : 0.0f;
+        const float score = q + scale * edge.prior / (1.0f + (float)visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+int Mcts::selectRoll(const ChanceNode& node) const {
+    // The roll with the largest deficit: expected visits (weight / 36 of the total) minus actual visits
+    const int64_t visits = load(node.visits);
+    int best = 0;
+    int64_t bestDeficit = INT64_MIN;
+    for (int r = 0; r < ROLLS; ++r) {
+        const int64_t deficit = (int64_t)ROLL_TABLE.weight[r] * (visits + 1) - 36 * (int64_t)load(decisions[node.firstChild + r].visits);
+        if (deficit > bestDeficit) {
+            bestDeficit = deficit;
+            best = r;
+        }
+    }
+    return best;
+}
+
+void Mcts::abandon(Worker& worker) {
+    for (const PathStep& step : worker.path) {
+        Edge& edge = edges[step.edge];
+        subtract(edge.visits, 1u);
+        add(edge.valueSum, virtualLoss);
+        subtract(decisions[step.node].visits, 1u);
+        if (step.chance != NONE) {
+            subtract(chances[step.chance].visits, 1u); // Keeps the visits equal to the sum over the rolls
+        }
+    }
+    worker.path.clear();
+}
+
+bool Mcts::simulate(Worker& worker) {
+    worker.path.clear();
+    uint32_t node = 0;
+    float value; // For the player on roll below the last edge of the path
+    for (;;) {
+        DecisionNode& decision = decisions[node];
+        uint32_t first = acquire(decision.firstEdge);
+        if (first == NONE) {
+            if (claim(decision.firstEdge, NONE, BUSY)) {
+                if (!expand(worker, node, value)) {
+                    release(decision.firstEdge, NONE);
+                    abandon(worker);
+                    return false;
+                }
+                add(decision.visits, 1u);
+                break;
+            }
+            first = acquire(decision.firstEdge);
+        }
+        if (first == BUSY || first == NONE) {
+            // Another thread is expanding the node: score it for this simulation only
+            value = evaluate(worker, node);
+            add(decision.visits, 1u);
+            worker.collisions++;
+            break;
+        }
+
+        // The visit and the virtual loss are taken now, so concurrent simulations see them
+        const uint32_t e = select(decision, first);
+        Edge& edge = edges[e];
+        add(edge.visits, 1u);
+        add(edge.valueSum, -virtualLoss);
+        add(decision.visits, 1u);
+        worker.path.push_back(PathStep{node, e, NONE});
+
+        uint32_t c = acquire(edge.chance);
+        if (c == NONE) {
+            if (claim(edge.chance, NONE, BUSY) && !createChance(worker, node, e)) {
+                release(edge.chance, NONE);
+                abandon(worker);
+                return false;
+            }
+            c = acquire(edge.chance);
+        }
+        while (c == BUSY) {
+            std::this_thread::yield();
+            c = acquire(edge.chance);
+        }
+        if (c == NONE) {
+            abandon(worker); // The thread creating the chance node ran out of memory
+            return false;
+        }
+        ChanceNode& chance = chances[c];
+        if (chance.terminal) {
+            value = -chance.outcome; // As if seen by the opponent, who would be on roll next
+            break;
+        }
+        node = chance.firstChild + (uint32_t)selectRoll(chance);
+        add(chance.visits, 1u);
+        worker.path.back().chance = c;
+    }
+
+    // Players alternate at every decision node, so the value changes sign at every level
+    for (size_t i = worker.path.size(); i-- > 0;) {
+        value = -value;
+        add(edges[worker.path[i].edge].valueSum, toFixed(value) + virtualLoss);
+    }
+    return true;
+}
+
+uint32_t Mcts::rootVisits(size_t play) const {
+    return edges[decisions[0].firstEdge + (uint32_t)play].visits;
+}
+
+void Mcts::policy(std::vector<float>& result) const {
+    result.resize(plays.size());
+    uint32_t total = 0;
+    for (size_t i = 0; i < plays.size(); ++i) {
+        total += rootVisits(i);
+    }
+    for (size_t i = 0; i < plays.size(); ++i) {
+        result[i] = total ? (float)rootVisits(i) / (float)total : 1.0f / (float)plays.size();
+    }
+}
+
+const Play& Mcts::bestPlay() const {
+    size_t best = 0;
+    for (size_t i = 1; i < plays.size(); ++i) {
+        if (rootVisits(i) > rootVisits(best)) {
+            best = i;
+        }
+    }
+    return plays[best];
+}
+
+double Mcts::rootValue() const {
+    int64_t sum = 0;
+    uint32_t visits = 0;
+    for (size_t i = 0; i < plays.size(); ++i) {
+        const Edge& edge = edges[decisions[0].firstEdge + (uint32_t)i];
+        sum += edge.valueSum;
+        visits += edge.visits;
+    }
+    return visits ? (double)sum / VALUE_SCALE / visits : 0.0;
+}
+
+size_t Mcts::nodeCount() const {
+    size_t count = decisions.size() + chances.size();
+    for (const std::unique_ptr<Mcts>& helper : helpers) {
+        count += helper->nodeCount();
+    }
+    return count;
+}
+
+size_t Mcts::memoryBytes() const {
+    size_t bytes = decisions.memoryBytes() + edges.memoryBytes() + chances.memoryBytes();
+    for (const std::unique_ptr<Mcts>& helper : helpers) {
+        bytes += helper->memoryBytes();
+    }
+    return bytes;
+}
+
+float randomRolloutEvaluator(const Board& board, const std::vector<Play>& plays, float* priors, Rng& rng) {
+    for (size_t i = 0; i < plays.size(); ++i) {
+        priors[i] = 1.0f;
+    }
+    thread_local std::vector<Play> legal;
+    Board game(board);
+    while (!game.isGameOver()) {
+        game.legalPlays(legal);
+        game.applyPlay(legal[rng.below((uint32_t)legal.size())], rng);
+    }
+    return (float)(game.getOutcome() * board.getCurrentPlayer());
+}
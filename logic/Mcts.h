@@ -0,0 +1,262 @@
+#ifndef MCTS_H
+#define MCTS_H
+#include <inttypes.h>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Board.h"
+#include "Play.h"
+#include "Rng.h"
+#include "NodeArena.h"
+
+
+
+/**
+ * @file Mcts.h
+ * @brief Monte Carlo tree search with explicit chance nodes for the dice.
+ *
+ * The tree alternates two kinds of nodes:
+ *  - Decision nodes: a board with the dice rolled. Each legal play is an edge with a prior, a visit
+ *    count and a value sum, and edges are selected with PUCT (the AlphaZero rule).
+ *  - Chance nodes: the board after a play, with the other player about to roll. Its children are
+ *    the decision nodes of the 21 distinct rolls, weighted 1/36 for doubles and 2/36 otherwise.
+ *    Rolls are not sampled at random: each visit takes the roll whose share of the visits is
+ *    furthest below its probability, so the visits follow the dice distribution with no sampling
+ *    noise.
+ *
+ * A decision node is evaluated once, when it is first reached: the evaluator gives the value of the
+ * position for the player on roll and a prior for every legal play. Games that end with a play are
+ * scored exactly. Values are equities in points (+1, +2, +3 for a single, gammon or backgammon win).
+ *
+ * Nodes live in NodeArenas and refer to each other by 32-bit indices: a decision node holds the
+ * range of its edges and a chance node the range of its 21 children, which are created together
+ * the first time the chance node is reached. Starting a search resets the arenas in O(1), so a new
+ * search reuses the memory of the previous one. A search stops early if the arenas are full.
+ *
+ * With more than one thread the search runs in one of two modes:
+ *  - Tree parallel: every thread runs simulations on the shared tree. Visit counts and value sums
+ *    are updated with atomic adds, and a thread that selects an edge adds a virtual loss to it until
+ *    its simulation is backed up, which steers the other threads to different lines. Expanding a
+ *    node or creating a chance node is claimed with a compare-and-swap; a thread that finds a node
+ *    being expanded by another evaluates it for its own simulation without expanding it.
+ *  - Root parallel: every thread searches its own tree from the root with its own seed, and the
+ *    statistics of the root plays are summed at the end. No memory is shared during the search.
+ * In both modes the iterations are the total over all threads, and the evaluator is called from
+ * every thread, so it must be thread-safe.
+ */
+class Mcts {
+    public:
+        /**
+         * @brief Evaluates a decision node.
+         * @param board The board, with the dice rolled.
+         * @param plays The legal plays (a single empty play when the roll cannot be played).
+         * @param priors Receives one prior per play (they need not be normalized).
+         * @param rng A generator for randomized evaluators (owned by the calling thread).
+         * @return The value of the position for the player on roll, in points.
+         */
+        typedef std::function<float(const Board& board, const std::vector<Play>& plays, float* priors, Rng& rng)> Evaluator;
+
+        enum class Parallelism {
+            TREE, // Threads share one tree
+            ROOT  // Threads search separate trees, merged at the root
+        };
+
+        struct Options {
+            uint32_t iterations = 800;  // Simulations per search, over all threads
+            float exploration = 1.5f;   // PUCT constant, in points since values are equities
+            uint64_t seed = 0;          // Seed of the generators passed to the evaluator
+            int threads = 1;            // Search threads, 0 for one per hardware thread
+            Parallelism parallelism = Parallelism::TREE;
+            float virtualLoss = 1.0f;   // Points subtracted from an edge while a thread searches below it
+        };
+
+        explicit Mcts(Evaluator evaluator);
+        Mcts(Evaluator evaluator, const Options& options);
+        ~Mcts();
+
+        /**
+         * @brief Searches a position from scratch.
+         * @param root The board to search, with the dice rolled for the player to move.
+         */
+        void search(const Board& root);
+
+        /**
+         * @brief Drops the tree, keeping the allocated storage.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the legal plays at the root, in the order used by the other root queries.
+         */
+        const std::vector<Play>& rootPlays() const { return plays; }
+
+        /**
+         * @brief Gets the number of visits of a root play.
+         */
+        uint32_t rootVisits(size_t play) const;
+
+        /**
+         * @brief Writes the visit-count policy: the share of the root visits of every root play.
+         */
+        void policy(std::vector<float>& result) const;
+
+        /**
+         * @brief Gets the most visited root play.
+         */
+        const Play& bestPlay() const;
+
+        /**
+         * @brief Gets the mean value of the root for the player to move, over the visits of its plays.
+         */
+        double rootValue() const;
+
+        /**
+         * @brief Gets the number of decision and chance nodes in the tree (in all trees when root parallel).
+         */
+        size_t nodeCount() const;
+
+        /**
+         * @brief Gets the memory held by the tree storage, in bytes (kept from one search to the next).
+         */
+        size_t memoryBytes() const;
+
+        /**
+         * @brief Gets the number of simulations of the last search that found their leaf being expanded
+         * by another thread (tree parallel only). A high share calls for a larger virtual loss.
+         */
+        uint64_t collisions() const { return collisionCount; }
+
+        static constexpr int ROLLS = 21;
+
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFFu;
+        static constexpr uint32_t BUSY = 0xFFFFFFFEu; // Being expanded or created by a thread
+
+        // Fields written by several threads are only accessed through the atomic helpers in Mcts.c++,
+        // so the nodes stay trivially copyable for the arenas
+        struct Edge {
+            Play play;
+            float prior;
+            uint32_t visits;  // Virtual visits included while a simulation is below the edge
+            uint32_t chance;  // Chance node reached by the play, NONE until first visited
+            int64_t valueSum; // For the player choosing the play, in units of 1 / VALUE_SCALE points
+        };
+
+        struct DecisionNode {
+            Board board;        // With the dice of the node's roll
+            uint32_t visits;    // Simulations through the node, its evaluation included
+            uint32_t firstEdge; // NONE until the node is evaluated
+            uint32_t edgeCount;
+        };
+
+        struct ChanceNode {
+            uint32_t firstChild; // Decision nodes of the 21 rolls, in the order of the roll table
+            uint32_t visits;
+            float outcome;       // For a play that ended the game, its value for the player who made it
+            bool terminal;
+        };
+
+        struct PathStep {
+            uint32_t node;   // Decision node
+            uint32_t edge;   // Edge taken from it
+            uint32_t chance; // Chance node visited below the edge, NONE if the simulation stopped before it
+        };
+
+        typedef NodeArena<DecisionNode, 12> DecisionArena;
+        typedef NodeArena<Edge, 14> EdgeArena;
+        typedef NodeArena<ChanceNode, 14> ChanceArena;
+
+        /**
+         * @brief The state of one search thread.
+         */
+        struct Worker {
+            Rng rng;
+            DecisionArena::Cursor decisions;
+            EdgeArena::Cursor edges;
+            ChanceArena::Cursor chances;
+            std::vector<Play> scratch;  // Legal plays of the node being expanded
+            std::vector<float> priors;
+            std::vector<PathStep> path; // Steps of the simulation in progress
+            uint64_t collisions = 0;
+
+            explicit Worker(Mcts& mcts) : rng(0), decisions(mcts.decisions), edges(mcts.edges), chances(mcts.chances) {}
+        };
+
+        Evaluator evaluator;
+        Options options;
+        DecisionArena decisions;
+        EdgeArena edges;
+        ChanceArena chances;
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::unique_ptr<Mcts>> helpers; // Separate trees of the root parallel mode
+        std::vector<Play> plays;                     // Root plays
+        int64_t virtualLoss = 0;                     // In value units, 0 when a single thread searches the tree
+        uint64_t collisionCount = 0;
+
+        /**
+         * @brief Resets the tree and evaluates the root with the first worker.
+         * @return false if the arenas are full.
+         */
+        bool start(const Board& root, uint64_t seed);
+
+        /**
+         * @brief Runs simulations on the tree from one thread until the shared budget is spent.
+         * @param remaining Simulations left over all the threads.
+         */
+        void run(Worker& worker, std::atomic<int64_t>& remaining);
+
+        /**
+         * @brief Runs one simulation from the root: select, expand, evaluate and back up.
+         * @return false if the arenas are full.
+         */
+        bool simulate(Worker& worker);
+
+        /**
+         * @brief Evaluates a decision node claimed by the worker and creates its edges.
+         * @param value Set to the value of the node for its player on roll.
+         * @return false if the arenas are full.
+         */
+        bool expand(Worker& worker, uint32_t node, float& value);
+
+        /**
+         * @brief Evaluates a decision node without expanding it (another thread is expanding it).
+         * @return The value of the node for its player on roll.
+         */
+        float evaluate(Worker& worker, uint32_t node);
+
+        /**
+         * @brief Creates the chance node reached by an edge (claimed by the worker), with its 21 children.
+         * @return false if the arenas are full.
+         */
+        bool createChance(Worker& worker, uint32_t node, uint32_t edge);
+
+        /**
+         * @brief Selects the edge of a decision node with the highest PUCT score.
+         */
+        uint32_t select(const DecisionNode& node, uint32_t firstEdge) const;
+
+        /**
+         * @brief Gets the roll of a chance node to visit next.
+         */
+        int selectRoll(const ChanceNode& node) const;
+
+        /**
+         * @brief Takes back the visits and virtual losses of a simulation that could not finish.
+         */
+        void abandon(Worker& worker);
+
+        /**
+         * @brief Searches with the root parallel mode and sums the root statistics into this tree.
+         */
+        void searchRootParallel(const Board& root, int threads);
+};
+
+/**
+ * @brief Evaluator with uniform priors and the result of one random game as the value.
+ */
+float randomRolloutEvaluator(const Board& board, const std::vector<Play>& plays, float* priors, Rng& rng);
+
+
+#endif // MCTS_H
@@ -0,0 +1,41 @@
+#include "MoveFilter.h"
+#include <algorithm>
+#include <chrono>
+
+MoveAnalysis analyzePlays(const Board& board, Expectiminimax& search, const MoveFilterOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    MoveAnalysis analysis;
+    for (const Play& play : board.legalPlays()) {
+        analysis.plays.push_back(CandidatePlay{play, 0.0f, -1});
+    }
+
+    // The first alive plays are the candidates of the next stage, best first once a stage has run
+    size_t alive = analysis.plays.size();
+    for (size_t s = 0; s < options.stages.size() && (s == 0 || alive > 1); ++s) {
+        const FilterStage& stage = options.stages[s];
+        const auto stageStart = std::chrono::steady_clock::now();
+        const uint64_t evaluations = search.stats().evaluations;
+        for (size_t i = 0; i < alive; ++i) {
+            CandidatePlay& candidate = analysis.plays[i];
+            candidate.equity = search.evaluatePlay(board, candidate.play, stage.depth);
+            candidate.depth = stage.depth;
+        }
+        std::stable_sort(analysis.plays.begin(), analysis.plays.begin() + alive, [](const CandidatePlay& a, const CandidatePlay& b) {
+            return a.equity > b.equity;
+        });
+
+        // The best play is always kept, whatever the window and limit (see FilterStage)
+        FilterStageReport report{stage.depth, alive, 1, 0, 0.0};
+        const size_t keep = std::min(alive, std::max<size_t>(stage.keep, 1));
+        const float threshold = analysis.plays[0].equity - stage.window;
+        while (report.kept < keep && analysis.plays[report.kept].equity >= threshold) {
+            report.kept++;
+        }
+        report.evaluations = search.stats().evaluations - evaluations;
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - stageStart).count();
+        analysis.stages.push_back(report);
+        alive = report.kept;
+    }
+    analysis.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return analysis;
+}
@@ -0,0 +1,69 @@
+#ifndef MOVEFILTER_H
+#define MOVEFILTER_H
+#include <inttypes.h>
+#include <cstddef>
+#include <vector>
+#include "Board.h"
+#include "Expectiminimax.h"
+#include "Play.h"
+
+
+
+/**
+ * @file MoveFilter.h
+ * @brief Play analysis through a pipeline of move filters, as in GNU Backgammon.
+ *
+ * Scoring every legal play at the full depth wastes most of the time on plays that are obviously
+ * bad. The analysis instead runs a list of stages: the first stage scores every legal play (usually
+ * at 0-ply), and each stage keeps the best plays within an equity window of the best, up to a limit,
+ * for the next stage to score at a greater depth. The analysis ends after the last stage, or as soon
+ * as a single play is left.
+ *
+ * Every legal play is reported with the equity of the deepest stage that scored it: the survivors of
+ * the last stage first, then the plays dropped by each earlier stage, each group from best to worst.
+ * The time and the evaluations spent by each stage are reported as well.
+ */
+
+struct FilterStage {
+    int depth;     // Depth in rolls the plays of the stage are scored at
+    size_t keep;   // Most plays passed on to the next stage; the best play always is, so 0 counts as 1
+    float window;  // Plays scoring further than this below the best are not passed on
+};
+
+struct MoveFilterOptions {
+    std::vector<FilterStage> stages = {{0, 8, 0.16f}, {1, 2, 0.04f}, {2, 1, 0.0f}};
+};
+
+struct CandidatePlay {
+    Play play;
+    float equity; // For the player on roll, in points
+    int depth;    // Depth the equity was scored at
+};
+
+struct FilterStageReport {
+    int depth;
+    size_t scored;        // Plays scored by the stage
+    size_t kept;          // Plays passed on to the next stage
+    uint64_t evaluations; // Static evaluations made by the stage
+    double seconds;
+};
+
+struct MoveAnalysis {
+    std::vector<CandidatePlay> plays;      // Every legal play, best first (see above)
+    std::vector<FilterStageReport> stages; // One per stage run
+    double seconds = 0.0;
+
+    const CandidatePlay& best() const { return plays[0]; }
+};
+
+/**
+ * @brief Analyzes the legal plays of a position through the move filters.
+ * @param board The board, with the dice rolled.
+ * @param search The search scoring the plays (its evaluator, pruning options and table are used).
+ * @param options The stages of the pipeline (at least one).
+ * @return The plays with their equities, and the cost of every stage.
+ */
+MoveAnalysis analyzePlays(const Board& board, Expectiminimax& search, const MoveFilterOptions& options = MoveFilterOptions());
+
+
+#endif // MOVEFILTER_H
@@ -0,0 +1,86 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+#include <inttypes.h>
+#include <cstdlib>
+#include <vector>
+
+
+
+/**
+ * @file MoveList.h
+ * @brief Fixed-capacity, stack-resident list of single checker moves.
+ *
+ * Move generation runs at every node of the legality search, so it writes into a MoveList
+ * owned by the caller instead of returning a freshly allocated std::vector.
+ */
+
+/**
+ * @brief A single checker move, encoded like the (from, distance) pairs of Board::validMoves.
+ * A distance of 7 enters a piece from the bar onto position from; player 2 distances are negative.
+ */
+struct Move {
+    int8_t from;     // Starting position of the piece (entry point for bar entries)
+    int8_t distance; // Distance to move (7 for bar entry, negative for player 2)
+
+    /**
+     * @brief Returns the die face consumed by the move.
+     * Bar entries are encoded with a distance of 7, so the face is recovered from the entry point.
+     */
+    int die() const {
+        if (distance == 7) {
+            return (from < 6) ? from + 1 : 24 - from; // Player 1 enters on 0-5, player 2 on 18-23
+        }
+        return std::abs(distance);
+    }
+
+    bool operator==(const Move& other) const { return from == other.from && distance == other.distance; }
+    bool operator!=(const Move& other) const { return !(*this == other); }
+};
+
+
+class MoveList {
+    public:
+        static constexpr int CAPACITY = 24 * 6; // Every point with every die face
+
+        MoveList() : count(0) {}
+
+        /**
+         * @brief Appends a move. The capacity bound is never reached by legal move generation.
+         */
+        void emplace_back(int from, int distance) {
+            moves[count++] = Move{(int8_t)from, (int8_t)distance};
+        }
+
+        void push_back(const Move& move) { moves[count++] = move; }
+
+        void clear() { count = 0; }
+
+        int size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        const Move& operator[](int i) const { return moves[i]; }
+
+        const Move* begin() const { return moves; }
+
+        const Move* end() const { return moves + count; }
+
+        /**
+         * @brief Copies the moves into a vector of (from, distance) pairs.
+         */
+        std::vector<std::pair<int, int>> toVector() const {
+            std::vector<std::pair<int, int>> result;
+            result.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                result.emplace_back(moves[i].from, moves[i].distance);
+            }
+            return result;
+        }
+
+    private:
+        Move moves[CAPACITY];
+        uint16_t count;
+};
+
+
+#endif // MOVELIST_H
@@ -0,0 +1,353 @@
+#include "NeuralNet.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = "BGNNET1";
+
+struct Header {
+    char magic[8];
+    uint32_t count;    // Layer sizes given, the inputs and outputs included
+    uint32_t sizes[4]; // Unused sizes are zero
+};
+
+inline int roundUp8(int n) { return (n + 7) & ~7; }
+
+void denseScalar(const float* input, int inputs, const float* weights, const float* bias, int stride, float* output) {
+    std::copy(bias, bias + stride, output);
+    for (int i = 0; i < inputs; ++i) {
+        const float x = input[i];
+        if (x == 0.0f) {
+            continue;
+        }
+        const float* row = weights + (size_t)i * stride;
+        for (int o = 0; o < stride; ++o) {
+            output[o] += x * row[o];
+        }
+    }
+}
+
+void sigmoidScalar(float* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        values[i] = 1.0f / (1.0f + std::exp(-values[i]));
+    }
+}
+
+// Gathers the nonzero inputs, so the vector kernels go through the rows of the active inputs only.
+// Branchless: which inputs are zero is too irregular to predict.
+inline int activeInputs(const float* input, int inputs, int* index, float* value) {
+    int active = 0;
+    for (int i = 0; i < inputs; ++i) {
+        index[active] = i;
+        value[active] = input[i];
+        active += input[i] != 0.0f;
+    }
+    return active;
+}
+
+// exp(x) = 2^n * exp(r) with n = round(x / ln 2) and |r| <= ln 2 / 2, exp(r) from the Cephes polynomial
+const float EXP_MAX = 87.0f; // exp(-x) and 1 + exp(-x) stay finite and normal
+const float LOG2E = 1.44269504089f;
+const float LN2_HIGH = 0.693359375f;    // Exact in a few bits, so n * LN2_HIGH is exact
+const float LN2_LOW = -2.12194440e-4f;
+const float EXP_P0 = 1.9875691500e-4f;
+const float EXP_P1 = 1.3981999507e-3f;
+const float EXP_P2 = 8.3334519073e-3f;
+const float EXP_P3 = 4.1665795894e-2f;
+const float EXP_P4 = 1.6666665459e-1f;
+const float EXP_P5 = 5.0000001201e-1f;
+
+} // namespace
+
+NeuralKernels neuralKernelsScalar() {
+    return NeuralKernels{denseScalar, sigmoidScalar, "scalar"};
+}
+
+#if defined(__x86_64__)
+
+namespace {
+
+void denseSse2(const float* input, int inputs, const float* weights, const float* bias, int stride, float* output) {
+    int index[NeuralNet::MAX_UNITS];
+    float value[NeuralNet::MAX_UNITS];
+    const int active = activeInputs(input, inputs, index, value);
+    int o = 0;
+    for (; o + 16 <= stride; o += 16) {
+        __m128 a0 = _mm_loadu_ps(bias + o);
+        __m128 a1 = _mm_loadu_ps(bias + o + 4);
+        __m128 a2 = _mm_loadu_ps(bias + o + 8);
+        __m128 a3 = _mm_loadu_ps(bias + o + 12);
+        for (int k = 0; k < active; ++k) {
+            const float* row = weights + (size_t)index[k] * stride + o;
+            const __m128 x = _mm_set1_ps(value[k]);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(x, _mm_loadu_ps(row)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(x, _mm_loadu_ps(row + 4)));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(x, _mm_loadu_ps(row + 8)));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(x, _mm_loadu_ps(row + 12)));
+        }
+        _mm_storeu_ps(output + o, a0);
+        _mm_storeu_ps(output + o + 4, a1);
+        _mm_storeu_ps(output + o + 8, a2);
+        _mm_storeu_ps(output + o + 12, a3);
+    }
+    if (o < stride) {
+        // 8 outputs left (all of them for the output layer): even and odd inputs go to separate
+        // accumulators, so the adds are not one long dependency chain
+        __m128 a0 = _mm_loadu_ps(bias + o);
+        __m128 a1 = _mm_loadu_ps(bias + o + 4);
+        __m128 b0 = _mm_setzero_ps();
+        __m128 b1 = _mm_setzero_ps();
+        int k = 0;
+        for (; k + 2 <= active; k += 2) {
+            const float* row = weights + (size_t)index[k] * stride + o;
+            const float* next = weights + (size_t)index[k + 1] * stride + o;
+            const __m128 x = _mm_set1_ps(value[k]);
+            const __m128 y = _mm_set1_ps(value[k + 1]);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(x, _mm_loadu_ps(row)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(x, _mm_loadu_ps(row + 4)));
+            b0 = _mm_add_ps(b0, _mm_mul_ps(y, _mm_loadu_ps(next)));
+            b1 = _mm_add_ps(b1, _mm_mul_ps(y, _mm_loadu_ps(next + 4)));
+        }
+        if (k < active) {
+            const float* row = weights + (size_t)index[k] * stride + o;
+            const __m128 x = _mm_set1_ps(value[k]);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(x, _mm_loadu_ps(row)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(x, _mm_loadu_ps(row + 4)));
+        }
+        _mm_storeu_ps(output + o, _mm_add_ps(a0, b0));
+        _mm_storeu_ps(output + o + 4, _mm_add_ps(a1, b1));
+    }
+}
+
+void sigmoidSse2(float* values, int count) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int i = 0; i < count; i += 4) {
+        // exp(-v)
+        const __m128 x = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(values + i)), _mm_set1_ps(-EXP_MAX)), _mm_set1_ps(EXP_MAX));
+        const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(LOG2E))); // Rounds to nearest
+        const __m128 fn = _mm_cvtepi32_ps(n);
+        const __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(LN2_HIGH))), _mm_mul_ps(fn, _mm_set1_ps(LN2_LOW)));
+        __m128 p = _mm_set1_ps(EXP_P0);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P1));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P2));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P3));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P4));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P5));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), r), one);
+        const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+        _mm_storeu_ps(values + i, _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(p, scale))));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void denseAvx2(const float* input, int inputs, const float* weights, const float* bias, int stride, float* output) {
+    int index[NeuralNet::MAX_UNITS];
+    float value[NeuralNet::MAX_UNITS];
+    const int active = activeInputs(input, inputs, index, value);
+    int o = 0;
+    for (; o + 32 <= stride; o += 32) {
+        __m256 a0 = _mm256_loadu_ps(bias + o);
+        __m256 a1 = _mm256_loadu_ps(bias + o + 8);
+        __m256 a2 = _mm256_loadu_ps(bias + o + 16);
+        __m256 a3 = _mm256_loadu_ps(bias + o + 24);
+        for (int k = 0; k < active; ++k) {
+            const float* row = weights + (size_t)index[k] * stride + o;
+            const __m256 x = _mm256_set1_ps(value[k]);
+            a0 = _mm256_fmadd_ps(x, _mm256_loadu_ps(row), a0);
+            a1 = _mm256_fmadd_ps(x, _mm256_loadu_ps(row + 8), a1);
+            a2 = _mm256_fmadd_ps(x, _mm256_loadu_ps(row + 16), a2);
+            a3 = _mm256_fmadd_ps(x, _mm256_loadu_ps(row + 24), a3);
+        }
+        _mm256_storeu_ps(output + o, a0);
+        _mm256_storeu_ps(output + o + 8, a1);
+        _mm256_storeu_ps(output + o + 16, a2);
+        _mm256_storeu_ps(output + o + 24, a3);
+    }
+    for (; o < stride; o += 8) {
+        // Blocks of 8 outputs (all of them for the output layer) split the inputs over 4 accumulators,
+        // so the FMAs are not one long dependency chain
+        __m256 a0 = _mm256_loadu_ps(bias + o);
+        __m256 a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps();
+        __m256 a3 = _mm256_setzero_ps();
+        int k = 0;
+        for (; k + 4 <= active; k += 4) {
+            a0 = _mm256_fmadd_ps(_mm256_set1_ps(value[k]), _mm256_loadu_ps(weights + (size_t)index[k] * stride + o), a0);
+            a1 = _mm256_fmadd_ps(_mm256_set1_ps(value[k + 1]), _mm256_loadu_ps(weights + (size_t)index[k + 1] * stride + o), a1);
+            a2 = _mm256_fmadd_ps(_mm256_set1_ps(value[k + 2]), _mm256_loadu_ps(weights + (size_t)index[k + 2] * stride + o), a2);
+            a3 = _mm256_fmadd_ps(_mm256_set1_ps(value[k + 3]), _mm256_loadu_ps(weights + (size_t)index[k + 3] * stride + o), a3);
+        }
+        for (; k < active; ++k) {
+            a0 = _mm256_fmadd_ps(_mm256_set1_ps(value[k]), _mm256_loadu_ps(weights + (size_t)index[k] * stride + o), a0);
+        }
+        _mm256_storeu_ps(output + o, _mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void sigmoidAvx2(float* values, int count) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (int i = 0; i < count; i += 8) {
+        // exp(-v)
+        const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(values + i)), _mm256_set1_ps(-EXP_MAX)), _mm256_set1_ps(EXP_MAX));
+        const __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(LOG2E))); // Rounds to nearest
+        const __m256 fn = _mm256_cvtepi32_ps(n);
+        const __m256 r = _mm256_fnmadd_ps(fn, _mm256_set1_ps(LN2_LOW), _mm256_fnmadd_ps(fn, _mm256_set1_ps(LN2_HIGH), x));
+        __m256 p = _mm256_set1_ps(EXP_P0);
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P1));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P2));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P3));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P4));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P5));
+        p = _mm256_add_ps(_mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r), one);
+        const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+        _mm256_storeu_ps(values + i, _mm256_div_ps(one, _mm256_fmadd_ps(p, scale, one)));
+    }
+}
+
+} // namespace
+
+NeuralKernels neuralKernelsSse2() {
+    return NeuralKernels{denseSse2, sigmoidSse2, "sse2"};
+}
+
+NeuralKernels neuralKernelsAvx2() {
+    return NeuralKernels{denseAvx2, sigmoidAvx2, "avx2"};
+}
+
+#endif
+
+NeuralKernels neuralKernels() {
+#if defined(__x86_64__)
+    static const NeuralKernels kernels = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? neuralKernelsAvx2() : neuralKernelsSse2();
+    return kernels;
+#else
+    return neuralKernelsScalar();
+#endif
+}
+
+NeuralNet::NeuralNet() : kernels(neuralKernels()) {}
+
+bool NeuralNet::create(const std::vector<int>& sizes) {
+    this->sizes.clear();
+    layers.clear();
+    if (sizes.size() < 3 || sizes.size() > 2 + MAX_HIDDEN_LAYERS || sizes.back() > MAX_OUTPUTS) {
+        return false;
+    }
+    for (int size : sizes) {
+        if (size < 1 || size > MAX_UNITS) {
+            return false;
+        }
+    }
+    this->sizes = sizes;
+    for (size_t l = 0; l + 1 < sizes.size(); ++l) {
+        Layer layer;
+        layer.inputs = sizes[l];
+        layer.outputs = sizes[l + 1];
+        layer.stride = roundUp8(layer.outputs);
+        layer.weights.assign((size_t)layer.inputs * layer.stride, 0.0f);
+        layer.bias.assign(layer.stride, 0.0f);
+        layers.push_back(std::move(layer));
+    }
+    return true;
+}
+
+void NeuralNet::randomize(Rng& rng, float scale) {
+    for (Layer& layer : layers) {
+        for (int i = 0; i < layer.inputs; ++i) {
+            for (int o = 0; o < layer.outputs; ++o) {
+                layer.weights[(size_t)i * layer.stride + o] = (float)(rng.uniform() * 2.0 - 1.0) * scale;
+            }
+        }
+        for (int o = 0; o < layer.outputs; ++o) {
+            layer.bias[o] = (float)(rng.uniform() * 2.0 - 1.0) * scale;
+        }
+    }
+}
+
+bool NeuralNet::load(const std::string& path) {
+    sizes.clear();
+    layers.clear();
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    Header header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+           && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+           && header.count >= 3 && header.count <= 4;
+    if (ok) {
+        ok = create(std::vector<int>(header.sizes, header.sizes + header.count));
+    }
+    std::vector<float> row;
+    for (size_t l = 0; ok && l < layers.size(); ++l) {
+        Layer& layer = layers[l];
+        row.resize(layer.outputs);
+        for (int i = 0; ok && i < layer.inputs; ++i) {
+            ok = std::fread(row.data(), sizeof(float), row.size(), file) == row.size();
+            std::copy(row.begin(), row.end(), layer.weights.begin() + (size_t)i * layer.stride);
+        }
+        ok = ok && std::fread(layer.bias.data(), sizeof(float), layer.outputs, file) == (size_t)layer.outputs;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        sizes.clear();
+        layers.clear();
+    }
+    return ok;
+}
+
+bool NeuralNet::save(const std::string& path) const {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.count = (uint32_t)sizes.size();
+    std::copy(sizes.begin(), sizes.end(), header.sizes);
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const Layer& layer : layers) {
+        for (int i = 0; ok && i < layer.inputs; ++i) {
+            ok = std::fwrite(layer.weights.data() + (size_t)i * layer.stride, sizeof(float), layer.outputs, file) == (size_t)layer.outputs;
+        }
+        ok = ok && std::fwrite(layer.bias.data(), sizeof(float), layer.outputs, file) == (size_t)layer.outputs;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+void NeuralNet::evaluate(const float* input, float* output) const {
+    // Padded lanes hold sigmoid(0) after each layer, but the next layer only reads its real inputs
+    alignas(32) float buffers[2][MAX_UNITS];
+    const float* in = input;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const Layer& layer = layers[l];
+        float* out = buffers[l & 1];
+        kernels.dense(in, layer.inputs, layer.weights.data(), layer.bias.data(), layer.stride, out);
+        kernels.sigmoid(out, layer.stride);
+        in = out;
+    }
+    std::copy(in, in + outputs(), output);
+}
+
+void NeuralNet::evaluate(const float* input, size_t count, float* output) const {
+    const size_t inputCount = (size_t)inputs();
+    const size_t outputCount = (size_t)outputs();
+    for (size_t row = 0; row < count; ++row) {
+        evaluate(input + row * inputCount, output + row * outputCount);
+    }
+}
+
+float NeuralNet::equity(const float* output, int outputs) {
+    float p[MAX_OUTPUTS] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    std::copy(output, output + std::min(outputs, (int)MAX_OUTPUTS), p);
+    // Gammon probabilities include the backgammons, which are worth one more point
+    return 2.0f * p[WIN] - 1.0f + p[WIN_GAMMON] - p[LOSE_GAMMON] + p[WIN_BACKGAMMON] - p[LOSE_BACKGAMMON];
+}
@@ -0,0 +1,172 @@
+#ifndef NEURALNET_H
+#define NEURALNET_H
+#include <inttypes.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Rng.h"
+
+
+
+/**
+ * @file NeuralNet.h
+ * @brief CPU inference for small TD-Gammon style networks: fully connected layers with sigmoids.
+ *
+ * A network has an input layer (198 units for the TD-Gammon encoding), one or two hidden layers
+ * and up to five outputs, every unit with a sigmoid activation. The outputs are the probabilities
+ * of the player on roll, in the order of GNU Backgammon: win, win a gammon, win a backgammon,
+ * lose a gammon, lose a backgammon. Networks with fewer outputs drop the last ones.
+ *
+ * The weights of a layer are stored input-major, each row padded to a multiple of 8 floats, so a
+ * layer is computed one input at a time by adding that input's row, scaled by its value, to the
+ * output vector. Inputs equal to zero are skipped, which is most of them in the TD-Gammon encoding.
+ * The row additions and the sigmoids are SIMD kernels (SSE2, or AVX2 with FMA when the CPU has it),
+ * with a scalar reference; the sigmoid kernels use a polynomial exp accurate to a few ulps.
+ *
+ * Weight file: a header (magic "BGNNET1", the number of layer sizes, then the sizes from the inputs
+ * to the outputs), then for every layer its weights, input-major, and its biases, as little-endian
+ * 32-bit floats.
+ */
+
+/**
+ * @brief The kernels of one instruction set.
+ */
+struct NeuralKernels {
+    /**
+     * @brief Computes output[0, stride) = bias + the sum of input[i] * weights[i * stride, (i + 1) * stride).
+     * stride is a multiple of 8 and the buffers need no alignment.
+     */
+    void (*dense)(const float* input, int inputs, const float* weights, const float* bias, int stride, float* output);
+
+    /**
+     * @brief Applies the logistic function in place to count values (a multiple of 8).
+     */
+    void (*sigmoid)(float* values, int count);
+
+    const char* name;
+};
+
+NeuralKernels neuralKernelsScalar();
+
+#if defined(__x86_64__)
+NeuralKernels neuralKernelsSse2();
+
+/**
+ * @brief AVX2 and FMA kernels. Only use them if the CPU supports both.
+ */
+NeuralKernels neuralKernelsAvx2();
+#endif
+
+/**
+ * @brief Returns the fastest kernels supported by the CPU (checked once, at the first call).
+ */
+NeuralKernels neuralKernels();
+
+class NeuralNet {
+    public:
+        static constexpr int TD_GAMMON_INPUTS = 198;
+        static constexpr int MAX_HIDDEN_LAYERS = 2;
+        static constexpr int MAX_OUTPUTS = 5;
+        static constexpr int MAX_UNITS = 1024; // Largest layer
+
+        enum Output {
+            WIN = 0,
+            WIN_GAMMON = 1,
+            WIN_BACKGAMMON = 2,
+            LOSE_GAMMON = 3,
+            LOSE_BACKGAMMON = 4
+        };
+
+        /**
+         * @brief Constructs an empty network (see create and load).
+         */
+        NeuralNet();
+
+        /**
+         * @brief Sets the shape of the network, with every weight and bias zero.
+         * @param sizes The layer sizes from the inputs to the outputs: 3 or 4 sizes of 1 to MAX_UNITS
+         * units, with at most MAX_OUTPUTS outputs.
+         * @return false if the shape is not supported.
+         */
+        bool create(const std::vector<int>& sizes);
+
+        /**
+         * @brief Draws every weight and bias uniformly in [-scale, scale].
+         */
+        void randomize(Rng& rng, float scale);
+
+        /**
+         * @brief Loads a weight file.
+         * @return false if the file cannot be read or is not a valid network (the network is then empty).
+         */
+        bool load(const std::string& path);
+
+        /**
+         * @brief Writes the network to a weight file.
+         */
+        bool save(const std::string& path) const;
+
+        bool empty() const { return sizes.empty(); }
+
+        int inputs() const { return sizes.empty() ? 0 : sizes.front(); }
+
+        int outputs() const { return sizes.empty() ? 0 : sizes.back(); }
+
+        /**
+         * @brief Gets the layer sizes from the inputs to the outputs.
+         */
+        const std::vector<int>& layerSizes() const { return sizes; }
+
+        /**
+         * @brief Gets the weight from a unit of a layer to a unit of the next one.
+         * @param layer The layer of weights, 0 for the weights from the inputs.
+         */
+        float weight(int layer, int from, int to) const { return layers[layer].weights[(size_t)from * layers[layer].stride + to]; }
+
+        void setWeight(int layer, int from, int to, float value) { layers[layer].weights[(size_t)from * layers[layer].stride + to] = value; }
+
+        float bias(int layer, int to) const { return layers[layer].bias[to]; }
+
+        void setBias(int layer, int to, float value) { layers[layer].bias[to] = value; }
+
+        /**
+         * @brief Selects the kernels (neuralKernels() by default).
+         */
+        void setKernels(const NeuralKernels& kernels) { this->kernels = kernels; }
+
+        /**
+         * @brief Evaluates the network.
+         * @param input inputs() values.
+         * @param output Receives outputs() probabilities.
+         */
+        void evaluate(const float* input, float* output) const;
+
+        /**
+         * @brief Evaluates the network on many inputs.
+         * @param input count rows of inputs() values, one after the other.
+         * @param count The number of rows.
+         * @param output Receives count rows of outputs() probabilities.
+         */
+        void evaluate(const float* input, size_t count, float* output) const;
+
+        /**
+         * @brief Gets the cubeless equity of outputs in the order of the Output enum (missing outputs count as 0).
+         */
+        static float equity(const float* output, int outputs);
+
+    private:
+        struct Layer {
+            int inputs;
+            int outputs;
+            int stride; // outputs rounded up to a multiple of 8
+            std::vector<float> weights; // inputs rows of stride floats
+            std::vector<float> bias;    // stride floats, zero past outputs
+        };
+
+        std::vector<int> sizes;
+        std::vector<Layer> layers;
+        NeuralKernels kernels;
+};
+
+
+#endif // NEURALNET_H
@@ -0,0 +1,167 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+#include <inttypes.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+
+
+
+/**
+ * @file NodeArena.h
+ * @brief Bump allocator for search tree nodes, addressed by 32-bit indices.
+ *
+ * Nodes live in slabs of SLAB_SIZE entries. An index is the slab number in its high bits and the
+ * offset in the slab in its low bits, so nodes refer to each other (or to a range of children)
+ * with 4-byte indices instead of pointers, and a lookup is a shift, a mask and two loads.
+ *
+ * allocate() hands out a contiguous range of nodes from the current slab, moving to the next slab
+ * when the range does not fit. Nothing is ever freed one node at a time: reset() forgets every node
+ * in O(1) and keeps the slabs, so the next search reuses warm memory without touching the system
+ * allocator. Nodes are not constructed or destroyed by the arena, which is why T must be trivially
+ * copyable; callers assign every field of the nodes they allocate.
+ *
+ * Several threads can allocate from the same arena through their own Cursor: a cursor claims
+ * whole slabs with one atomic increment and then bumps within its slab without synchronization.
+ * The slab table never moves, so indices handed out by one thread stay valid for all of them.
+ */
+template <typename T, int SLAB_BITS = 16>
+class NodeArena {
+    static_assert(std::is_trivially_copyable<T>::value, "Arena nodes are never constructed or destroyed");
+
+    public:
+        static constexpr uint32_t SLAB_SIZE = 1u << SLAB_BITS;
+        static constexpr uint32_t MAX_SLABS = 1u << (32 - SLAB_BITS);
+        static constexpr uint32_t NONE = 0xFFFFFFFFu; // Index of no node
+        static constexpr uint32_t DEFAULT_SLABS = 4096;
+
+        /**
+         * @brief Per-thread allocation state: a bump pointer in a slab claimed from the arena.
+         */
+        class Cursor {
+            public:
+                explicit Cursor(NodeArena& arena) : arena(&arena) {}
+
+                /**
+                 * @brief Allocates a contiguous range of nodes.
+                 * @param count The number of nodes (at most SLAB_SIZE).
+                 * @return The index of the first node, or NONE if the arena is full.
+                 */
+                uint32_t allocate(uint32_t count) {
+                    if (generation != arena->generation.load(std::memory_order_relaxed)) {
+                        // The arena was reset: the claimed slab may belong to someone else now
+                        generation = arena->generation.load(std::memory_order_relaxed);
+                        next = end = 0;
+                    }
+                    if (end - next < count) {
+                        const uint32_t slab = arena->claimSlab();
+                        if (slab == NONE) {
+                            return NONE;
+                        }
+                        next = slab << SLAB_BITS;
+                        end = next + SLAB_SIZE;
+                    }
+                    const uint32_t first = next;
+                    next += count;
+                    arena->allocated.fetch_add(count, std::memory_order_relaxed);
+                    return first;
+                }
+
+            private:
+                NodeArena* arena;
+                uint32_t next = 0;          // First free index of the claimed slab
+                uint32_t end = 0;           // End of the claimed slab
+                uint32_t generation = NONE; // Arena generation the slab was claimed in
+        };
+
+        /**
+         * @brief Constructs an empty arena. No slab is allocated until the first node is.
+         * @param maxSlabs The most slabs the arena may hold (at most MAX_SLABS).
+         */
+        explicit NodeArena(uint32_t maxSlabs = DEFAULT_SLABS)
+            : slabLimit(maxSlabs < MAX_SLABS ? maxSlabs : MAX_SLABS), cursor(*this) {
+            slabs.reset(new std::atomic<T*>[slabLimit]);
+            for (uint32_t i = 0; i < slabLimit; ++i) {
+                slabs[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~NodeArena() {
+            for (uint32_t i = 0; i < slabLimit; ++i) {
+                std::free(slabs[i].load(std::memory_order_relaxed));
+            }
+        }
+
+        NodeArena(const NodeArena&) = delete;
+        NodeArena& operator=(const NodeArena&) = delete;
+
+        T& operator[](uint32_t index) {
+            return slabs[index >> SLAB_BITS].load(std::memory_order_relaxed)[index & (SLAB_SIZE - 1)];
+        }
+
+        const T& operator[](uint32_t index) const {
+            return slabs[index >> SLAB_BITS].load(std::memory_order_relaxed)[index & (SLAB_SIZE - 1)];
+        }
+
+        /**
+         * @brief Allocates a contiguous range of nodes from the arena's own cursor (single-threaded use).
+         * @param count The number of nodes (at most SLAB_SIZE).
+         * @return The index of the first node, or NONE if the arena is full.
+         */
+        uint32_t allocate(uint32_t count = 1) { return cursor.allocate(count); }
+
+        /**
+         * @brief Forgets every node in O(1), keeping the slabs for reuse.
+         * No thread may allocate or read nodes during the reset.
+         */
+        void reset() {
+            usedSlabs.store(0, std::memory_order_relaxed);
+            allocated.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the number of nodes allocated since the last reset.
+         */
+        size_t size() const { return allocated.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Gets the memory held by the slabs, in bytes (kept across resets).
+         */
+        size_t memoryBytes() const {
+            size_t bytes = 0;
+            for (uint32_t i = 0; i < slabLimit && slabs[i].load(std::memory_order_relaxed) != nullptr; ++i) {
+                bytes += sizeof(T) * SLAB_SIZE;
+            }
+            return bytes;
+        }
+
+    private:
+        std::unique_ptr<std::atomic<T*>[]> slabs; // Slab table, never reallocated
+        uint32_t slabLimit;
+        std::atomic<uint32_t> usedSlabs{0};       // Slabs claimed since the last reset
+        std::atomic<size_t> allocated{0};
+        std::atomic<uint32_t> generation{0};      // Incremented by reset, so cursors drop their slab
+        Cursor cursor;
+
+        /**
+         * @brief Claims the next slab, allocating its memory the first time it is used.
+         * @return The slab number, or NONE if every slab is in use.
+         */
+        uint32_t claimSlab() {
+            const uint32_t slab = usedSlabs.fetch_add(1, std::memory_order_relaxed);
+            if (slab >= slabLimit) {
+                return NONE;
+            }
+            if (slabs[slab].load(std::memory_order_acquire) == nullptr) {
+                // Only the claiming thread touches a slab's pointer until indices into it are published
+                slabs[slab].store((T*)std::malloc(sizeof(T) * SLAB_SIZE), std::memory_order_release);
+            }
+            return slab;
+        }
+};
+
+
+#endif // NODEARENA_H
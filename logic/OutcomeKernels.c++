@@ -0,0 +1,135 @@
+#include "OutcomeKernels.h"
+#include "Side.h"
+#include <cstring>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Outcome of a single game, the reference every vector lane must agree with.
+ */
+inline int8_t outcomeOf(const OutcomeInputs& in, size_t game) {
+    // Backgammon if the loser is on the bar or in the winner's home board, gammon if they
+    // have not borne off any piece, single win otherwise
+    const int player1Margin = (in.bar[1][game] > 0 || (in.occupied[1][game] & Side<1>::HOME) != 0) ? 3 : (in.onBoard[1][game] == 15 ? 2 : 1);
+    const int player2Margin = (in.bar[0][game] > 0 || (in.occupied[0][game] & Side<-1>::HOME) != 0) ? 3 : (in.onBoard[0][game] == 15 ? 2 : 1);
+    const bool player1Won = (in.occupied[0][game] | in.bar[0][game]) == 0;
+    const bool player2Won = (in.occupied[1][game] | in.bar[1][game]) == 0;
+    return (int8_t)(player1Won ? player1Margin : (player2Won ? -player2Margin : 0));
+}
+
+} // namespace
+
+void outcomesScalar(const OutcomeInputs& in, int8_t* outcomes, size_t games) {
+    for (size_t game = 0; game < games; ++game) {
+        outcomes[game] = outcomeOf(in, game);
+    }
+}
+
+#if defined(__x86_64__)
+
+namespace {
+
+// Zero-extends 4 bytes into 4 32-bit lanes
+inline __m128i loadBytes4(const uint8_t* p) {
+    int32_t bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+}
+
+} // namespace
+
+void outcomesSse2(const OutcomeInputs& in, int8_t* outcomes, size_t games) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i fifteen = _mm_set1_epi32(15);
+    const __m128i home1 = _mm_set1_epi32((int)Side<1>::HOME);
+    const __m128i home2 = _mm_set1_epi32((int)Side<-1>::HOME);
+    size_t game = 0;
+    for (; game + 4 <= games; game += 4) {
+        const __m128i occupied1 = _mm_loadu_si128((const __m128i*)(in.occupied[0] + game));
+        const __m128i occupied2 = _mm_loadu_si128((const __m128i*)(in.occupied[1] + game));
+        const __m128i bar1 = loadBytes4(in.bar[0] + game);
+        const __m128i bar2 = loadBytes4(in.bar[1] + game);
+        const __m128i onBoard1 = loadBytes4(in.onBoard[0] + game);
+        const __m128i onBoard2 = loadBytes4(in.onBoard[1] + game);
+
+        // Lanes are all ones where a predicate holds
+        const __m128i player1Won = _mm_cmpeq_epi32(_mm_or_si128(occupied1, bar1), zero);
+        const __m128i player2Won = _mm_cmpeq_epi32(_mm_or_si128(occupied2, bar2), zero);
+        const __m128i backgammon1 = _mm_xor_si128(_mm_cmpeq_epi32(_mm_or_si128(bar2, _mm_and_si128(occupied2, home1)), zero), ones);
+        const __m128i backgammon2 = _mm_xor_si128(_mm_cmpeq_epi32(_mm_or_si128(bar1, _mm_and_si128(occupied1, home2)), zero), ones);
+        const __m128i gammon1 = _mm_cmpeq_epi32(onBoard2, fifteen);
+        const __m128i gammon2 = _mm_cmpeq_epi32(onBoard1, fifteen);
+
+        // margin = 1 + (gammon or backgammon) + backgammon, with masks worth -1
+        const __m128i margin1 = _mm_sub_epi32(_mm_sub_epi32(one, _mm_or_si128(gammon1, backgammon1)), backgammon1);
+        const __m128i margin2 = _mm_sub_epi32(_mm_sub_epi32(one, _mm_or_si128(gammon2, backgammon2)), backgammon2);
+        const __m128i result = _mm_or_si128(_mm_and_si128(player1Won, margin1),
+                                            _mm_and_si128(_mm_andnot_si128(player1Won, player2Won), _mm_sub_epi32(zero, margin2)));
+
+        const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(result, result), zero);
+        const int32_t bytes = _mm_cvtsi128_si32(packed);
+        std::memcpy(outcomes + game, &bytes, sizeof(bytes));
+    }
+    for (; game < games; ++game) {
+        outcomes[game] = outcomeOf(in, game);
+    }
+}
+
+__attribute__((target("avx2")))
+void outcomesAvx2(const OutcomeInputs& in, int8_t* outcomes, size_t games) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i fifteen = _mm256_set1_epi32(15);
+    const __m256i home1 = _mm256_set1_epi32((int)Side<1>::HOME);
+    const __m256i home2 = _mm256_set1_epi32((int)Side<-1>::HOME);
+    const __m256i firstDwords = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    size_t game = 0;
+    for (; game + 8 <= games; game += 8) {
+        const __m256i occupied1 = _mm256_loadu_si256((const __m256i*)(in.occupied[0] + game));
+        const __m256i occupied2 = _mm256_loadu_si256((const __m256i*)(in.occupied[1] + game));
+        const __m256i bar1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in.bar[0] + game)));
+        const __m256i bar2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in.bar[1] + game)));
+        const __m256i onBoard1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in.onBoard[0] + game)));
+        const __m256i onBoard2 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in.onBoard[1] + game)));
+
+        // Lanes are all ones where a predicate holds
+        const __m256i player1Won = _mm256_cmpeq_epi32(_mm256_or_si256(occupied1, bar1), zero);
+        const __m256i player2Won = _mm256_cmpeq_epi32(_mm256_or_si256(occupied2, bar2), zero);
+        const __m256i backgammon1 = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_or_si256(bar2, _mm256_and_si256(occupied2, home1)), zero), ones);
+        const __m256i backgammon2 = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_or_si256(bar1, _mm256_and_si256(occupied1, home2)), zero), ones);
+        const __m256i gammon1 = _mm256_cmpeq_epi32(onBoard2, fifteen);
+        const __m256i gammon2 = _mm256_cmpeq_epi32(onBoard1, fifteen);
+
+        // margin = 1 + (gammon or backgammon) + backgammon, with masks worth -1
+        const __m256i margin1 = _mm256_sub_epi32(_mm256_sub_epi32(one, _mm256_or_si256(gammon1, backgammon1)), backgammon1);
+        const __m256i margin2 = _mm256_sub_epi32(_mm256_sub_epi32(one, _mm256_or_si256(gammon2, backgammon2)), backgammon2);
+        const __m256i result = _mm256_or_si256(_mm256_and_si256(player1Won, margin1),
+                                               _mm256_and_si256(_mm256_andnot_si256(player1Won, player2Won), _mm256_sub_epi32(zero, margin2)));
+
+        // Packing works within each 128-bit half, so each half ends with its 4 bytes in its first dword
+        const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(result, result), zero);
+        const __m256i gathered = _mm256_permutevar8x32_epi32(packed, firstDwords);
+        _mm_storel_epi64((__m128i*)(outcomes + game), _mm256_castsi256_si128(gathered));
+    }
+    for (; game < games; ++game) {
+        outcomes[game] = outcomeOf(in, game);
+    }
+}
+
+#endif
+
+OutcomeKernel outcomeKernel() {
+#if defined(__x86_64__)
+    static const OutcomeKernel kernel = __builtin_cpu_supports("avx2") ? outcomesAvx2 : outcomesSse2;
+    return kernel;
+#else
+    return outcomesScalar;
+#endif
+}
@@ -0,0 +1,56 @@
+#ifndef OUTCOMEKERNELS_H
+#define OUTCOMEKERNELS_H
+#include <inttypes.h>
+#include <cstddef>
+
+
+
+/**
+ * @file OutcomeKernels.h
+ * @brief Vectorized game-over, gammon and backgammon tests over many games at once.
+ *
+ * The kernels take the struct-of-arrays fields of BoardBatch (occupancy masks, checkers on the
+ * board and on the bar per side, one entry per game) and write the outcome of every game with
+ * the same encoding as Board::getOutcome. Every predicate (all borne off, loser on the bar, loser
+ * in the winner's home board, loser has not borne off) is a compare or mask test on 32-bit lanes,
+ * so 4 games are decided per SSE2 instruction and 8 per AVX2 instruction.
+ *
+ * outcomeKernel() picks the widest variant the CPU supports the first time it is called; the
+ * scalar version is the reference and the fallback on other architectures.
+ */
+
+/**
+ * @brief The inputs of an outcome kernel, one entry per game in every array.
+ */
+struct OutcomeInputs {
+    const uint32_t* occupied[2]; // Occupancy masks per side
+    const uint8_t* onBoard[2];   // Checkers on the points per side (bar excluded)
+    const uint8_t* bar[2];       // Checkers on the bar per side
+};
+
+typedef void (*OutcomeKernel)(const OutcomeInputs& in, int8_t* outcomes, size_t games);
+
+/**
+ * @brief Reference implementation, one game at a time.
+ */
+void outcomesScalar(const OutcomeInputs& in, int8_t* outcomes, size_t games);
+
+#if defined(__x86_64__)
+/**
+ * @brief SSE2 implementation, 4 games per iteration (SSE2 is part of every x86-64 CPU).
+ */
+void outcomesSse2(const OutcomeInputs& in, int8_t* outcomes, size_t games);
+
+/**
+ * @brief AVX2 implementation, 8 games per iteration. Only call it if the CPU supports AVX2.
+ */
+void outcomesAvx2(const OutcomeInputs& in, int8_t* outcomes, size_t games);
+#endif
+
+/**
+ * @brief Returns the fastest kernel supported by the CPU (checked once, at the first call).
+ */
+OutcomeKernel outcomeKernel();
+
+
+#endif // OUTCOMEKERNELS_H
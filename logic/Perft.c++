@@ -0,0 +1,74 @@
+#include "Perft.h"
+#include "PlayTree.h"
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct PerftSearch {
+    PerftResult result;
+    std::vector<PlayTree> trees;         // One tree per depth, so storage is reused across rolls
+    std::vector<uint32_t> leaves;        // Leaves of the tree being expanded
+    std::unordered_set<uint64_t> seen;   // Keys of the positions reached at the leaves
+
+    void leaf(const Position& position) {
+        result.leaves++;
+        seen.insert(position.key);
+    }
+
+    /**
+     * @brief Deals every roll to the player to move and recurses into every play.
+     * @param position The position to expand, with no dice left.
+     * @param depth The number of turns still to expand.
+     */
+    void expand(const Position& position, int depth) {
+        if (depth == 0 || Board(position).isGameOver()) {
+            leaf(position);
+            return;
+        }
+        PlayTree& tree = trees[depth - 1];
+        for (int high = 1; high <= 6; ++high) {
+            for (int low = 1; low <= high; ++low) {
+                Position rolled = position;
+                if (high == low) {
+                    rolled.setDice(high, 4);
+                } else {
+                    rolled.setDice(high, 1);
+                    rolled.setDice(low, 1);
+                }
+                tree.build(Board(rolled));
+                result.turns++;
+                result.nodes += tree.size();
+
+                // Legal leaves are distinct complete plays; the tree below is rebuilt by the recursion,
+                // so every leaf is copied out before recursing
+                tree.leaves(leaves);
+                std::vector<Position> plays;
+                for (uint32_t leaf : leaves) {
+                    plays.push_back(tree.node(leaf).position);
+                }
+                for (Position& next : plays) {
+                    for (int face = 1; face <= 6; ++face) {
+                        next.setDice(face, 0); // Dice that could not be played are forfeited
+                    }
+                    next.setCurrentPlayer(-next.currentPlayer);
+                    expand(next, depth - 1);
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+PerftResult perft(const Board& board, int depth) {
+    PerftSearch search;
+    search.trees.resize(depth > 0 ? depth : 0);
+    Position start = board.position();
+    for (int face = 1; face <= 6; ++face) {
+        start.setDice(face, 0);
+    }
+    search.expand(start, depth);
+    search.result.uniquePositions = search.seen.size();
+    return search.result;
+}
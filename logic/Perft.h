@@ -0,0 +1,40 @@
+#ifndef PERFT_H
+#define PERFT_H
+#include <inttypes.h>
+#include "Board.h"
+
+
+
+/**
+ * @file Perft.h
+ * @brief Exhaustive play counting ("perft") over dice outcomes and legal plays.
+ *
+ * From a starting board, every one of the 21 distinct rolls is dealt to the player to move,
+ * every distinct legal play of that roll is made, and the same is repeated for the other
+ * player until the requested number of turns. The board's own dice are ignored.
+ *
+ * Rolls are not weighted by probability (a non-double counts once, like a double) and a roll
+ * that cannot be played gives one empty play, so the counts only depend on the rules. This
+ * makes them a regression oracle for the move generator as well as a throughput benchmark.
+ */
+
+/**
+ * @brief Counts gathered by perft.
+ */
+struct PerftResult {
+    uint64_t leaves = 0;          // Play sequences of the requested depth (or ending the game earlier)
+    uint64_t uniquePositions = 0; // Distinct positions at the leaves (by Zobrist key, dice excluded)
+    uint64_t turns = 0;           // Rolls expanded, i.e. play trees built
+    uint64_t nodes = 0;           // States searched inside those play trees (single checker moves)
+};
+
+/**
+ * @brief Expands every roll and every legal play to a number of turns.
+ * @param board The starting board; its current player moves first.
+ * @param depth The number of turns to expand (0 returns the board itself as the only leaf).
+ * @return The leaf, unique position, turn and node counts.
+ */
+PerftResult perft(const Board& board, int depth);
+
+
+#endif // PERFT_H
@@ -0,0 +1,51 @@
+#ifndef PLAY_H
+#define PLAY_H
+#include <inttypes.h>
+#include "MoveList.h"
+
+
+
+/**
+ * @file Play.h
+ * @brief A complete play: the sequence of checker moves made with one roll.
+ *
+ * A play holds up to four single checker moves (four for doubles) in the order they are made,
+ * using the (from, distance) encoding of Move. It is 9 bytes and trivially copyable, so lists
+ * of plays can be generated and scored without allocating per play.
+ */
+struct Play {
+    static constexpr int MAX_MOVES = 4; // Doubles play four dice
+
+    Move moves[MAX_MOVES]; // Checker moves, in playing order
+    uint8_t count = 0;     // Number of moves (0 when the roll cannot be played)
+
+    void push_back(const Move& move) { moves[count++] = move; }
+
+    void pop_back() { count--; }
+
+    int size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    const Move& operator[](int i) const { return moves[i]; }
+
+    const Move* begin() const { return moves; }
+
+    const Move* end() const { return moves + count; }
+
+    bool operator==(const Play& other) const {
+        if (count != other.count) {
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (moves[i] != other.moves[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const Play& other) const { return !(*this == other); }
+};
+
+
+#endif // PLAY_H
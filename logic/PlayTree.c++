@@ -0,0 +1,201 @@
+#include "PlayTree.h"
+#include "Board.h"
+#include <algorithm>
+#include <vector>
+
+PlayTree::PlayTree(const Board& board) {
+    build(board);
+}
+
+void PlayTree::build(const Board& board) {
+    nodes.clear();
+    edges.clear();
+    std::fill(slots.begin(), slots.end(), 0); // Storage is kept between builds, so rebuilding does not allocate
+    if (slots.empty()) {
+        slots.resize(256, 0);
+    }
+    Board scratch(board); // The only copy made during the search
+    // Nobody changes player during a turn, so the player is dispatched once for the whole search
+    (scratch.getCurrentPlayer() == 1) ? expand<1>(scratch) : expand<-1>(scratch);
+}
+
+uint32_t& PlayTree::slotFor(const Position& position) {
+    const uint32_t mask = (uint32_t)slots.size() - 1;
+    for (uint32_t i = (uint32_t)position.key & mask; ; i = (i + 1) & mask) {
+        if (slots[i] == 0 || nodes[slots[i] - 1].position == position) {
+            return slots[i];
+        }
+    }
+}
+
+void PlayTree::growSlots() {
+    slots.assign(slots.size() * 2, 0);
+    for (uint32_t id = 0; id < nodes.size(); ++id) {
+        slotFor(nodes[id].position) = id + 1;
+    }
+}
+
+template <int Player>
+uint32_t PlayTree::expand(Board& board) {
+    uint32_t& slot = slotFor(board.position());
+    if (slot != 0) {
+        return slot - 1; // Transposition: this state was already expanded through another ordering
+    }
+
+    uint32_t id = (uint32_t)nodes.size();
+    nodes.push_back(Node{board.position(), 0, 0, board.diceLeft()});
+    slot = id + 1;
+    if (nodes.size() * 2 > slots.size()) {
+        growSlots(); // Keep the load factor under one half
+    }
+
+    MoveList moves;
+    board.generateMoves<Player>(moves);
+    if (moves.empty()) {
+        return id; // Turn is over, the dice left are the dice that could not be used
+    }
+
+    // Expand every child first; nodes may be reallocated, so only indices are kept
+    uint32_t children[MoveList::CAPACITY];
+    int dieLeftMin = 7; // Greater than the maximum amount of dice (4)
+    for (int i = 0; i < moves.size(); ++i) {
+        MoveUndo undo = board.doMove<Player>(moves[i].from, moves[i].distance);
+        children[i] = expand<Player>(board);
+        board.undoMove<Player>(undo);
+        dieLeftMin = std::min(dieLeftMin, (int)nodes[children[i]].minDiceLeft);
+    }
+
+    // If not every die can be used, only moves using the highest possible die are legal
+    int maxDice = 0;
+    if (dieLeftMin > 0) {
+        for (int i = 0; i < moves.size(); ++i) {
+            if (nodes[children[i]].minDiceLeft == dieLeftMin) {
+                maxDice = std::max(maxDice, moves[i].die());
+            }
+        }
+    }
+
+    Node& node = nodes[id];
+    node.firstEdge = (uint32_t)edges.size();
+    node.minDiceLeft = (uint8_t)dieLeftMin;
+    for (int i = 0; i < moves.size(); ++i) {
+        if (nodes[children[i]].minDiceLeft == dieLeftMin && (maxDice == 0 || moves[i].die() == maxDice)) {
+            edges.push_back(Edge{moves[i], children[i]});
+            node.edgeCount++;
+        }
+    }
+    return id;
+}
+
+int64_t PlayTree::child(uint32_t index, int from, int distance) const {
+    const Node& node = nodes[index];
+    for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; ++e) {
+        if (edges[e].move.from == from && edges[e].move.distance == distance) {
+            return edges[e].child;
+        }
+    }
+    return -1; // Not a legal move from this node
+}
+
+std::vector<std::pair<int, int>> PlayTree::moves(uint32_t index) const {
+    MoveList result;
+    moves(index, result);
+    return result.toVector();
+}
+
+void PlayTree::moves(uint32_t index, MoveList& result) const {
+    const Node& node = nodes[index];
+    result.clear();
+    for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; ++e) {
+        result.push_back(edges[e].move);
+    }
+}
+
+size_t PlayTree::playCount() const {
+    std::vector<uint32_t> found;
+    leaves(found);
+    return found.size();
+}
+
+void PlayTree::leaves(std::vector<uint32_t>& result, uint32_t start) const {
+    result.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    // Every distinct leaf reached through legal edges is a distinct final state, i.e. a distinct play
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<uint32_t> stack = {start};
+    visited[start] = true;
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        if (node.edgeCount == 0) {
+            result.push_back(stack.back());
+        }
+        stack.pop_back();
+        for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; ++e) {
+            if (!visited[edges[e].child]) {
+                visited[edges[e].child] = true;
+                stack.push_back(edges[e].child);
+            }
+        }
+    }
+}
+
+std::vector<std::vector<std::pair<int, int>>> PlayTree::plays() const {
+    std::vector<Play> found;
+    plays(found);
+    std::vector<std::vector<std::pair<int, int>>> result;
+    result.reserve(found.size());
+    for (const Play& play : found) {
+        std::vector<std::pair<int, int>> path;
+        for (const Move& m : play) {
+            path.emplace_back(m.from, m.distance);
+        }
+        result.push_back(std::move(path));
+    }
+    return result;
+}
+
+void PlayTree::plays(std::vector<Play>& result, uint32_t start) const {
+    result.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    // Depth-first walk that records one path to each leaf; nodes are visited once so
+    // transposed orderings of the same play are skipped
+    std::vector<bool> visited(nodes.size(), false);
+    Play path;
+    std::pair<uint32_t, uint32_t> stack[Play::MAX_MOVES + 1]; // (node, next edge to try), a turn is at most four moves deep
+    int depth = 0;
+    stack[depth++] = {start, nodes[start].firstEdge};
+    visited[start] = true;
+    if (nodes[start].edgeCount == 0) {
+        result.push_back(path);
+        return;
+    }
+    while (depth > 0) {
+        auto& top = stack[depth - 1];
+        const Node& node = nodes[top.first];
+        if (top.second == node.firstEdge + node.edgeCount) {
+            depth--;
+            if (!path.empty()) {
+                path.pop_back();
+            }
+            continue;
+        }
+        const Edge& edge = edges[top.second++];
+        if (visited[edge.child]) {
+            continue;
+        }
+        visited[edge.child] = true;
+        path.push_back(edge.move);
+        if (nodes[edge.child].edgeCount == 0) {
+            result.push_back(path);
+            path.pop_back();
+        } else {
+            stack[depth++] = {edge.child, nodes[edge.child].firstEdge};
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#ifndef PLAYTREE_H
+#define PLAYTREE_H
+#include <inttypes.h>
+#include <vector>
+#include "Position.h"
+#include "MoveList.h"
+#include "Play.h"
+
+class Board;
+
+
+
+/**
+ * @file PlayTree.h
+ * @brief Header file for the PlayTree class, the full-turn legal move generator.
+ *
+ * A PlayTree enumerates every legal way to play the current roll once, applying the
+ * rules that the most dice must be used and that the higher die must be used when only
+ * one of them can be played. Each node is a board state reached during the turn and each
+ * edge a single checker move (using the same (from, distance) encoding as Board::validMoves).
+ *
+ * States reached through different orderings of the same checker moves (transpositions) are
+ * merged into a single node, so the search is done once per distinct state instead of once
+ * per path, and every leaf reached through legal moves is a distinct complete play (see leaves()).
+ *
+ */
+class PlayTree {
+    public:
+
+        /**
+         * @brief A board state reached during the turn.
+         */
+        struct Node {
+            Position position;  // Board state at this point of the turn
+            uint32_t firstEdge; // Index of the first legal move out of this node
+            uint8_t edgeCount;  // Number of legal moves out of this node (0 once the turn is over)
+            uint8_t minDiceLeft; // Fewest dice that can be left unused from this state
+        };
+
+        /**
+         * @brief A legal single checker move between two nodes.
+         */
+        struct Edge {
+            Move move;      // The checker move
+            uint32_t child; // Index of the node reached by the move
+        };
+
+        /**
+         * @brief Constructs an empty PlayTree.
+         */
+        PlayTree() = default;
+
+        /**
+         * @brief Constructs the PlayTree for the current roll of a board.
+         * @param board The board whose current player and dice are expanded.
+         */
+        explicit PlayTree(const Board& board);
+
+        /**
+         * @brief Rebuilds the tree for the current roll of a board, reusing allocated storage.
+         * @param board The board whose current player and dice are expanded.
+         */
+        void build(const Board& board);
+
+        /**
+         * @brief Gets a node of the tree. Node 0 is the start of the turn.
+         */
+        const Node& node(uint32_t index) const { return nodes[index]; }
+
+        /**
+         * @brief Gets the number of nodes (distinct states) in the tree.
+         */
+        uint32_t size() const { return (uint32_t)nodes.size(); }
+
+        /**
+         * @brief Finds the node reached by playing a move from a node.
+         * @param index The node to move from.
+         * @param from The starting position of the piece.
+         * @param distance The distance to move the piece.
+         * @return The index of the child node, or -1 if the move is not legal from that node.
+         */
+        int64_t child(uint32_t index, int from, int distance) const;
+
+        /**
+         * @brief Returns the legal single checker moves from a node.
+         * @param index The node to move from.
+         * @return A vector of (from, distance) pairs.
+         */
+        std::vector<std::pair<int, int>> moves(uint32_t index) const;
+
+        /**
+         * @brief Writes the legal single checker moves from a node into a caller-provided list.
+         * @param index The node to move from.
+         * @param moves The list to fill (cleared first).
+         */
+        void moves(uint32_t index, MoveList& moves) const;
+
+        /**
+         * @brief Counts the distinct complete plays of the turn (transpositions counted once).
+         */
+        size_t playCount() const;
+
+        /**
+         * @brief Writes the index of every node ending a legal play reachable from a node.
+         * Only legal edges are followed: a node with no moves left that is reached only through moves
+         * pruned by the max-dice or higher-die rules is not a play.
+         * @param result The list to fill (cleared first), one node per distinct complete play.
+         * @param start The node to play from (0 for the whole turn).
+         */
+        void leaves(std::vector<uint32_t>& result, uint32_t start = 0) const;
+
+        /**
+         * @brief Returns one move sequence per distinct complete play of the turn.
+         * @return A vector of plays, each a sequence of (from, distance) pairs.
+         * An empty play is returned when the roll cannot be played at all.
+         */
+        std::vector<std::vector<std::pair<int, int>>> plays() const;
+
+        /**
+         * @brief Writes one Play per distinct complete play reachable from a node.
+         * @param result The list to fill (cleared first). A single empty play is written when
+         * the node ends the turn.
+         * @param start The node to play from (0 for the whole turn).
+         */
+        void plays(std::vector<Play>& result, uint32_t start = 0) const;
+
+    private:
+        std::vector<Node> nodes;
+        std::vector<Edge> edges;
+        std::vector<uint32_t> slots; // Open addressing transposition table (node index + 1, 0 when empty)
+
+        /**
+         * @brief Finds the slot of a position in the transposition table.
+         * @return The slot holding the position, or the empty slot where it should be inserted.
+         */
+        uint32_t& slotFor(const Position& position);
+
+        /**
+         * @brief Doubles the transposition table and reinserts every node.
+         */
+        void growSlots();
+
+        /**
+         * @brief Expands a state and all the states reachable from it during the turn.
+         * Moves are explored in place with Board::doMove/undoMove, so the board is
+         * back in its original state when this returns.
+         * @tparam Player The player to move (1 or -1), fixed for the whole turn.
+         * @param board The board state to expand.
+         * @return The index of the node for that state.
+         */
+        template <int Player>
+        uint32_t expand(Board& board);
+};
+
+
+#endif // PLAYTREE_H
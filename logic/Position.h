@@ -0,0 +1,244 @@
+#ifndef POSITION_H
+#define POSITION_H
+#include <inttypes.h>
+#include <cstring>
+#include <type_traits>
+#include "Zobrist.h"
+
+
+
+/**
+ * @file Position.h
+ * @brief Packed, trivially copyable storage for a backgammon position.
+ *
+ * Checker counts are stored as 4-bit nibbles (two points per byte), which is enough
+ * since a player never has more than 15 checkers on a point. Next to the counts we keep
+ * per-player occupancy bitmasks (bit i refers to point i) so that the hot predicates of
+ * move generation ("is this point blocked", "are all checkers home") become single mask tests.
+ *
+ * Side index 0 is player 1 (moves from 0 to 23), side index 1 is player 2 (moves from 23 to 0).
+ *
+ * A 64-bit Zobrist key (see Zobrist.h) is kept up to date by the setters below, so it costs
+ * two XORs per changed count. The setters also keep each side's pip count and number of checkers
+ * still in play, so pipCount(), checkersOff() and the mask-derived highestPoint() and hasContact()
+ * are O(1). Code that writes points, bar, dice or currentPlayer directly must call refresh() afterwards.
+ *
+ * The whole struct fits in a single cache line and is copied with a plain memcpy.
+ */
+struct Position {
+    uint64_t key;           // Zobrist key of the checkers, bars, dice and player to move
+    uint8_t  points[2][12]; // 4-bit checker counts per point, two points per byte, per side
+    uint32_t occupied[2];   // Bit i set if the side has at least one checker on point i
+    uint32_t made[2];       // Bit i set if the side has two or more checkers on point i (blocks the opponent)
+    uint8_t  bar[2];        // Number of checkers on the bar per side
+    uint8_t  dice[6];       // How many times each die face can still be played (4 for doubles)
+    int8_t   currentPlayer; // Player to move (1 or -1)
+    uint16_t pips[2];       // Pip count per side (sum of the distances of its checkers to bearing off)
+    uint8_t  inPlay[2];     // Checkers per side on the points or on the bar (15 minus the checkers borne off)
+
+    static constexpr uint32_t ALL_POINTS = 0xFFFFFFu; // Mask covering points 0 to 23
+
+    /**
+     * @brief Converts a player (1 or -1) into a side index (0 or 1).
+     */
+    static int sideIndex(int player) { return player == 1 ? 0 : 1; }
+
+    static constexpr int BAR_DISTANCE = 25; // Pips from the bar to bearing off
+
+    /**
+     * @brief Returns how many pips a checker on a point is from bearing off (1 to 24).
+     * Side 0 bears off past point 23 and side 1 past point 0.
+     */
+    static int pipDistance(int side, int point) { return side == 0 ? 24 - point : point + 1; }
+
+    /**
+     * @brief Clears all checkers, bars and dice.
+     */
+    void clear() {
+        *this = Position{};
+        currentPlayer = 1;
+    }
+
+    /**
+     * @brief Returns the number of checkers a side has on a point.
+     * @param side The side index (0 for player 1, 1 for player 2).
+     * @param point The point index (0 to 23).
+     */
+    uint8_t count(int side, int point) const {
+        return (points[side][point >> 1] >> ((point & 1) << 2)) & 0x0F;
+    }
+
+    /**
+     * @brief Sets the number of checkers a side has on a point and updates the occupancy masks.
+     * @param side The side index (0 for player 1, 1 for player 2).
+     * @param point The point index (0 to 23).
+     * @param n The new checker count (0 to 15).
+     */
+    void setCount(int side, int point, uint8_t n) {
+        const int shift = (point & 1) << 2;
+        uint8_t& cell = points[side][point >> 1];
+        key ^= ZOBRIST.points[side][point][(cell >> shift) & 0x0F] ^ ZOBRIST.points[side][point][n & 0x0F];
+        const int delta = (int)(n & 0x0F) - (int)((cell >> shift) & 0x0F);
+        pips[side] = (uint16_t)(pips[side] + delta * pipDistance(side, point));
+        inPlay[side] = (uint8_t)(inPlay[side] + delta);
+        cell = (uint8_t)((cell & ~(0x0F << shift)) | ((n & 0x0F) << shift));
+        const uint32_t bit = 1u << point;
+        occupied[side] = n > 0 ? (occupied[side] | bit) : (occupied[side] & ~bit);
+        made[side] = n > 1 ? (made[side] | bit) : (made[side] & ~bit);
+    }
+
+    /**
+     * @brief Sets the number of checkers a side has on the bar.
+     */
+    void setBar(int side, uint8_t n) {
+        key ^= ZOBRIST.bar[side][bar[side]] ^ ZOBRIST.bar[side][n];
+        pips[side] = (uint16_t)(pips[side] + ((int)n - (int)bar[side]) * BAR_DISTANCE);
+        inPlay[side] = (uint8_t)(inPlay[side] + n - bar[side]);
+        bar[side] = n;
+    }
+
+    /**
+     * @brief Sets how many times a die face can still be played.
+     * @param face The die face (1 to 6).
+     * @param n The number of dice left with that face (0 to 4).
+     */
+    void setDice(int face, uint8_t n) {
+        key ^= ZOBRIST.dice[face - 1][dice[face - 1]] ^ ZOBRIST.dice[face - 1][n];
+        dice[face - 1] = n;
+    }
+
+    /**
+     * @brief Sets the player to move (1 or -1).
+     */
+    void setCurrentPlayer(int player) {
+        if (player != currentPlayer) {
+            key ^= ZOBRIST.player2ToMove;
+        }
+        currentPlayer = (int8_t)player;
+    }
+
+    /**
+     * @brief Computes the Zobrist key from scratch.
+     */
+    uint64_t computeKey() const {
+        uint64_t k = (currentPlayer == 1) ? 0 : ZOBRIST.player2ToMove;
+        for (int side = 0; side < 2; ++side) {
+            for (int point = 0; point < 24; ++point) {
+                k ^= ZOBRIST.points[side][point][count(side, point)];
+            }
+            k ^= ZOBRIST.bar[side][bar[side]];
+        }
+        for (int face = 0; face < 6; ++face) {
+            k ^= ZOBRIST.dice[face][dice[face]];
+        }
+        return k;
+    }
+
+    /**
+     * @brief Recomputes the Zobrist key, pip counts and checkers in play after fields were written directly.
+     */
+    void refresh() {
+        key = computeKey();
+        for (int side = 0; side < 2; ++side) {
+            int total = bar[side] * BAR_DISTANCE;
+            for (int point = 0; point < 24; ++point) {
+                total += count(side, point) * pipDistance(side, point);
+            }
+            pips[side] = (uint16_t)total;
+            inPlay[side] = (uint8_t)(checkersOnBoard(side) + bar[side]);
+        }
+    }
+
+    /**
+     * @brief Adds a checker for a side on a point.
+     */
+    void addChecker(int side, int point) { setCount(side, point, count(side, point) + 1); }
+
+    /**
+     * @brief Removes a checker for a side from a point.
+     */
+    void removeChecker(int side, int point) { setCount(side, point, count(side, point) - 1); }
+
+    /**
+     * @brief Returns the points on which a side has exactly one checker.
+     */
+    uint32_t blots(int side) const { return occupied[side] & ~made[side]; }
+
+    /**
+     * @brief Checks whether a side has a checker on a point.
+     */
+    bool hasChecker(int side, int point) const { return (occupied[side] >> point) & 1u; }
+
+    /**
+     * @brief Checks whether a point is blocked for a side (the opponent has made the point).
+     */
+    bool isBlocked(int side, int point) const { return (made[side ^ 1] >> point) & 1u; }
+
+    /**
+     * @brief Checks whether two positions hold the same checkers, bars, dice and player to move.
+     * The occupancy masks and the key are derived from the other fields, so they are not compared.
+     */
+    bool operator==(const Position& other) const {
+        return std::memcmp(points, other.points, sizeof(points)) == 0
+            && bar[0] == other.bar[0] && bar[1] == other.bar[1]
+            && std::memcmp(dice, other.dice, sizeof(dice)) == 0
+            && currentPlayer == other.currentPlayer;
+    }
+
+    bool operator!=(const Position& other) const { return !(*this == other); }
+
+    /**
+     * @brief Returns the total number of checkers a side still has on the board (bar excluded).
+     */
+    int checkersOnBoard(int side) const {
+        int total = 0;
+        for (int i = 0; i < 12; ++i) {
+            total += (points[side][i] & 0x0F) + (points[side][i] >> 4);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the pip count of a side: the total distance its checkers must travel to bear off.
+     */
+    int pipCount(int side) const { return pips[side]; }
+
+    /**
+     * @brief Returns the number of checkers a side has borne off.
+     */
+    int checkersOff(int side) const { return 15 - inPlay[side]; }
+
+    /**
+     * @brief Returns the distance from bearing off of a side's rearmost checker.
+     * @return 25 if the side has a checker on the bar, 1 to 24 for a checker on a point, 0 if all are off.
+     */
+    int highestPoint(int side) const {
+        if (bar[side] > 0) {
+            return BAR_DISTANCE;
+        }
+        if (occupied[side] == 0) {
+            return 0;
+        }
+        return side == 0 ? 24 - __builtin_ctz(occupied[side]) : 32 - __builtin_clz(occupied[side]);
+    }
+
+    /**
+     * @brief Checks whether the two sides can still hit or block each other.
+     * Contact is over (the game is a race) once every checker of side 0 has passed every checker of side 1.
+     */
+    bool hasContact() const {
+        if (bar[0] > 0 || bar[1] > 0) {
+            return true;
+        }
+        if (occupied[0] == 0 || occupied[1] == 0) {
+            return false;
+        }
+        return __builtin_ctz(occupied[0]) < 31 - __builtin_clz(occupied[1]); // Rearmost of side 0 behind rearmost of side 1
+    }
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must be trivially copyable");
+static_assert(sizeof(Position) <= 64, "Position must fit in a single cache line");
+
+
+#endif // POSITION_H
@@ -0,0 +1,168 @@
+#include "PositionKey.h"
+#include <cstring>
+
+namespace {
+
+const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+typedef unsigned __int128 KeyBits;
+
+// The point of a side that is its j-th point counted from its own 1-point (j = 0 to 23)
+inline int pointFromOwn(int side, int j) { return side == 0 ? 23 - j : j; }
+
+int base64Value(char c) {
+    const char* p = std::strchr(BASE64, c);
+    return (p != nullptr && c != '\0') ? (int)(p - BASE64) : -1;
+}
+
+// Checks that the runs of ones describe at most 15 checkers per side, separators included in 80 bits,
+// with every bit past the last separator clear
+bool isValidKey(KeyBits bits) {
+    int used = 0;
+    for (int side = 0; side < 2; ++side) {
+        int checkers = 0;
+        for (int j = 0; j < 25; ++j) {
+            while (used < 80 && ((bits >> used) & 1) != 0) {
+                checkers++;
+                used++;
+            }
+            if (used == 80 || checkers > 15) {
+                return false; // No room left for the separator, or too many checkers
+            }
+            used++;
+        }
+    }
+    return (bits >> used) == 0;
+}
+
+KeyBits keyBits(const uint8_t bytes[10]) {
+    KeyBits bits = 0;
+    for (int i = 0; i < 10; ++i) {
+        bits |= (KeyBits)bytes[i] << (8 * i);
+    }
+    return bits;
+}
+
+} // namespace
+
+PositionKey PositionKey::encode(const Position& position) {
+    const int onRoll = Position::sideIndex(position.currentPlayer);
+    const int order[2] = {onRoll ^ 1, onRoll}; // Opponent first, then the player on roll
+    KeyBits bits = 0;
+    int bit = 0;
+    for (int side : order) {
+        for (int j = 0; j < 25; ++j) {
+            const int n = (j < 24) ? position.count(side, pointFromOwn(side, j)) : position.bar[side];
+            bits |= (KeyBits)((1u << n) - 1) << bit; // n ones, then the 0 separator
+            bit += n + 1;
+        }
+    }
+    PositionKey key;
+    for (int i = 0; i < 10; ++i) {
+        key.bytes[i] = (uint8_t)(bits >> (8 * i));
+    }
+    return key;
+}
+
+bool PositionKey::decode(int player, Position& position) const {
+    KeyBits bits = keyBits(bytes);
+    if (!isValidKey(bits)) {
+        return false; // Runs are at most 15 long from here on, so the low 64 bits always hold a separator
+    }
+    position.clear();
+    const int onRoll = Position::sideIndex(player);
+    const int order[2] = {onRoll ^ 1, onRoll};
+    for (int side : order) {
+        for (int j = 0; j < 25; ++j) {
+            const int n = __builtin_ctzll(~(uint64_t)bits); // Length of the run of ones
+            bits >>= n + 1;
+            if (j < 24) {
+                position.setCount(side, pointFromOwn(side, j), (uint8_t)n);
+            } else {
+                position.setBar(side, (uint8_t)n);
+            }
+        }
+    }
+    position.setCurrentPlayer(player);
+    return true;
+}
+
+std::string PositionKey::toId() const {
+    std::string id;
+    id.reserve(14);
+    const uint8_t* p = bytes;
+    for (int i = 0; i < 3; ++i, p += 3) {
+        id += BASE64[p[0] >> 2];
+        id += BASE64[((p[0] & 0x03) << 4) | (p[1] >> 4)];
+        id += BASE64[((p[1] & 0x0F) << 2) | (p[2] >> 6)];
+        id += BASE64[p[2] & 0x3F];
+    }
+    id += BASE64[p[0] >> 2];
+    id += BASE64[(p[0] & 0x03) << 4];
+    return id;
+}
+
+bool PositionKey::fromId(const std::string& id, PositionKey& key) {
+    if (id.size() != 14) {
+        return false;
+    }
+    int v[14];
+    for (int i = 0; i < 14; ++i) {
+        v[i] = base64Value(id[i]);
+        if (v[i] < 0) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        const int* c = v + 4 * i;
+        key.bytes[3 * i] = (uint8_t)((c[0] << 2) | (c[1] >> 4));
+        key.bytes[3 * i + 1] = (uint8_t)(((c[1] & 0x0F) << 4) | (c[2] >> 2));
+        key.bytes[3 * i + 2] = (uint8_t)(((c[2] & 0x03) << 6) | c[3]);
+    }
+    key.bytes[9] = (uint8_t)((v[12] << 2) | (v[13] >> 4));
+    return isValidKey(keyBits(key.bytes));
+}
+
+bool PositionKey::operator==(const PositionKey& other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+}
+
+PositionRecord PositionRecord::encode(const Position& position) {
+    PositionRecord record;
+    const PositionKey key = PositionKey::encode(position);
+    std::memcpy(record.bytes, key.bytes, sizeof(key.bytes));
+    uint16_t word = 0;
+    for (int face = 5; face >= 0; --face) {
+        word = (uint16_t)(word * 5 + position.dice[face]); // Base 5, face 1 least significant
+    }
+    if (position.currentPlayer == -1) {
+        word |= 0x8000;
+    }
+    record.bytes[10] = (uint8_t)word;
+    record.bytes[11] = (uint8_t)(word >> 8);
+    return record;
+}
+
+bool PositionRecord::decode(Position& position) const {
+    uint16_t word = (uint16_t)(bytes[10] | (bytes[11] << 8));
+    if ((word & 0x3FFF) >= 5 * 5 * 5 * 5 * 5 * 5 || (word & 0x4000) != 0) {
+        return false; // Not 6 base 5 digits, or the unused bit is set
+    }
+    PositionKey key;
+    std::memcpy(key.bytes, bytes, sizeof(key.bytes));
+    Position decoded;
+    if (!key.decode((word & 0x8000) ? -1 : 1, decoded)) {
+        return false;
+    }
+    word &= 0x3FFF;
+    for (int face = 1; face <= 6; ++face) {
+        decoded.setDice(face, (uint8_t)(word % 5));
+        word /= 5;
+    }
+    position = decoded;
+    return true;
+}
+
+bool PositionRecord::operator==(const PositionRecord& other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+}
@@ -0,0 +1,86 @@
+#ifndef POSITIONKEY_H
+#define POSITIONKEY_H
+#include <inttypes.h>
+#include <string>
+#include "Position.h"
+
+
+
+/**
+ * @file PositionKey.h
+ * @brief Compact, exact encodings of positions: the 80-bit gnubg position key and a 12-byte record.
+ *
+ * The position key lists, for the opponent and then for the player on roll, the checkers on each
+ * of the 24 points counted from that player's own 1-point (the point next to bearing off) and then
+ * on the bar. Every point is written as one 1 bit per checker followed by a 0 bit, least significant
+ * bit first, so 15 + 15 checkers and 50 separators always fit in 80 bits. This is the key used by
+ * GNU Backgammon, and toId() gives its 14-character Base64 position ID.
+ *
+ * The key is relative to the player on roll: a position and its mirror image with the other player
+ * on roll share a key. PositionRecord adds the side to move and the dice to get an exact record.
+ */
+struct PositionKey {
+    uint8_t bytes[10]; // 80 bits, least significant bit first
+
+    /**
+     * @brief Encodes the checkers of a position as seen by its player on roll.
+     */
+    static PositionKey encode(const Position& position);
+
+    /**
+     * @brief Writes the checkers of the key into a position (dice are cleared).
+     * @param player The player on roll (1 or -1), which orients the key on the board.
+     * @param position The position to overwrite.
+     * @return false, leaving the position unchanged, if the key does not describe a position (see fromId()).
+     */
+    bool decode(int player, Position& position) const;
+
+    /**
+     * @brief Returns the 14-character Base64 position ID used by GNU Backgammon.
+     */
+    std::string toId() const;
+
+    /**
+     * @brief Parses a 14-character Base64 position ID.
+     * @param id The position ID.
+     * @param key Set to the parsed key.
+     * @return false if the ID has the wrong length, characters outside the Base64 alphabet, or does not
+     * describe a position (more than 15 checkers for a side, or more than 80 bits in use).
+     */
+    static bool fromId(const std::string& id, PositionKey& key);
+
+    bool operator==(const PositionKey& other) const;
+    bool operator!=(const PositionKey& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Fixed-width binary record of a position: checkers, dice left and player to move.
+ * Bytes 0 to 9 hold the position key. Bytes 10 and 11 hold a little-endian 16-bit word: bits 0 to 13
+ * are the dice left of each face (0 to 4) in base 5, face 1 least significant, and bit 15 is set when
+ * player 2 (-1) is to move. Records have no padding and can be written to files as they are.
+ */
+struct PositionRecord {
+    uint8_t bytes[12];
+
+    /**
+     * @brief Encodes a position.
+     */
+    static PositionRecord encode(const Position& position);
+
+    /**
+     * @brief Decodes the record into a position (key, pip counts and masks included).
+     * @param position The position to overwrite.
+     * @return false, leaving the position unchanged, if the record is corrupted: the key does not describe
+     * a position, or the dice word is not 6 base 5 digits with bit 14 clear.
+     */
+    bool decode(Position& position) const;
+
+    bool operator==(const PositionRecord& other) const;
+    bool operator!=(const PositionRecord& other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(PositionKey) == 10, "PositionKey must be 80 bits");
+static_assert(sizeof(PositionRecord) == 12, "PositionRecord must be 12 bytes");
+
+
+#endif // POSITIONKEY_H
@@ -0,0 +1,103 @@
+#ifndef RNG_H
+#define RNG_H
+#include <inttypes.h>
+#include <random>
+
+
+
+/**
+ * @file Rng.h
+ * @brief Small, fast random number generator used for dice rolls and random playouts.
+ *
+ * The generator is xoshiro256** (Blackman and Vigna), seeded through splitmix64. It holds
+ * 32 bytes of state, takes no lock and is reproducible from a single 64-bit seed, so
+ * every thread can own one (see Rng::threadLocal) or a caller can pass an explicitly
+ * seeded generator to Board::rollDice, Board::reset and Board::step.
+ *
+ * Bounded draws use Lemire's multiply-and-reject method, so dice are unbiased.
+ */
+class Rng {
+    public:
+
+        /**
+         * @brief Constructs a generator from a 64-bit seed.
+         * @param seed Any value, including 0; the same seed always gives the same sequence.
+         */
+        explicit Rng(uint64_t seed) { this->seed(seed); }
+
+        /**
+         * @brief Resets the generator to the sequence of a seed.
+         * @param seed Any value, including 0.
+         */
+        void seed(uint64_t seed) {
+            for (int i = 0; i < 4; ++i) {
+                // splitmix64 spreads the seed over the whole state (never all zero)
+                seed += 0x9e3779b97f4a7c15ull;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                state[i] = z ^ (z >> 31);
+            }
+        }
+
+        /**
+         * @brief Returns the next 64 random bits.
+         */
+        uint64_t next() {
+            const uint64_t result = rotl(state[1] * 5, 7) * 9;
+            const uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            return result;
+        }
+
+        /**
+         * @brief Returns a uniformly distributed integer in [0, bound).
+         * @param bound The exclusive upper bound (must be greater than 0).
+         */
+        uint32_t below(uint32_t bound) {
+            uint64_t m = (next() >> 32) * bound;
+            uint32_t low = (uint32_t)m;
+            if (low < bound) {
+                const uint32_t threshold = (0u - bound) % bound; // 2^32 mod bound
+                while (low < threshold) {
+                    m = (next() >> 32) * bound;
+                    low = (uint32_t)m;
+                }
+            }
+            return (uint32_t)(m >> 32);
+        }
+
+        /**
+         * @brief Rolls a single die.
+         * @return A face between 1 and 6.
+         */
+        int rollDie() { return (int)below(6) + 1; }
+
+        /**
+         * @brief Returns a uniformly distributed double in [0, 1).
+         */
+        double uniform() { return (double)(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+        /**
+         * @brief Gets the generator owned by the calling thread.
+         * It is seeded once from std::random_device the first time a thread uses it;
+         * call seed() on it for a reproducible run.
+         */
+        static Rng& threadLocal() {
+            thread_local Rng rng(((uint64_t)std::random_device{}() << 32) ^ std::random_device{}());
+            return rng;
+        }
+
+    private:
+        uint64_t state[4];
+
+        static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+
+#endif // RNG_H
@@ -0,0 +1,160 @@
+#include "Rollout.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const uint64_t CHUNK = 16; // Games taken from the shared counter at a time
+
+// splitmix64 finalizer, used to derive independent streams from (seed, game) pairs
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Plays the games of a rollout, one thread's share at a time.
+ */
+struct RolloutRun {
+    const Board& start;
+    const PlayoutPolicy& policy;
+    const RolloutOptions& options;
+    std::vector<double> equities; // One per game, summed in order once every game is played
+    std::vector<uint8_t> truncated;
+    std::atomic<uint64_t> next{0};
+    std::exception_ptr error; // First exception thrown by the policy or the evaluator, on any thread
+    std::mutex errorMutex;
+    uint64_t block = 1; // 36^rotatedTurns, the number of games over which the rotation is balanced
+
+    RolloutRun(const Board& start, const PlayoutPolicy& policy, const RolloutOptions& options)
+        : start(start), policy(policy), options(options), equities(options.games), truncated(options.games) {
+        for (int t = 0; t < options.rotatedTurns; ++t) {
+            block *= 36;
+        }
+    }
+
+    /**
+     * @brief Gets the roll of a turn with rotated dice, as an index between 0 and 35.
+     * The turn's digit of the game number in base 36 is rotated by an offset that depends on the
+     * seed, the block and the digits of the previous turns, so every block plays each sequence of
+     * rolls once and different prefixes see the rolls in different orders.
+     */
+    int rotatedRoll(uint64_t game, int turn) const {
+        uint64_t power = 1;
+        for (int t = 0; t < turn; ++t) {
+            power *= 36;
+        }
+        const uint64_t digit = (game / power) % 36;
+        const uint64_t offset = mix(options.seed ^ mix(game % power) ^ mix((game / block) + ((uint64_t)turn << 56))) % 36;
+        return (int)((digit + offset) % 36);
+    }
+
+    void play(uint64_t game, Rng& rng, std::vector<Play>& plays) {
+        rng.seed(mix(options.seed) ^ mix(game));
+        const int player = start.getCurrentPlayer();
+        Board board(start);
+        for (int ply = 0; !board.isGameOver(); ++ply) {
+            if (options.truncateAfter > 0 && ply == options.truncateAfter) {
+                // applyPlay rolled for the player on roll; the evaluator sees the position before the roll
+                Position unrolled = board.position();
+                for (int face = 1; face <= 6; ++face) {
+                    unrolled.setDice(face, 0);
+                }
+                equities[game] = options.evaluator(Board(unrolled)) * player;
+                truncated[game] = 1;
+                return;
+            }
+            if (ply < options.rotatedTurns) {
+                const int roll = rotatedRoll(game, ply);
+                board.setDice(roll / 6 + 1, roll % 6 + 1);
+            } else if (ply == 0) {
+                board.rollDice(rng); // The start position may hold dice; the first roll is part of the rollout
+            }
+            board.legalPlays(plays);
+            board.applyPlay(plays[policy(board, plays, rng)], rng); // Also rolls for the next player
+        }
+        equities[game] = board.getOutcome() * player;
+    }
+
+    void work() {
+        Rng rng(0);
+        std::vector<Play> plays;
+        try {
+            for (;;) {
+                const uint64_t first = next.fetch_add(CHUNK);
+                if (first >= options.games) {
+                    return;
+                }
+                const uint64_t last = std::min(first + CHUNK, options.games);
+                for (uint64_t game = first; game < last; ++game) {
+                    play(game, rng, plays);
+                }
+            }
+        } catch (...) {
+            // Kept for the caller, since an exception leaving a std::thread terminates the process
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(options.games); // The other threads stop after their current chunk
+        }
+    }
+};
+
+} // namespace
+
+size_t randomPolicy(const Board& board, const std::vector<Play>& plays, Rng& rng) {
+    (void)board;
+    return rng.below((uint32_t)plays.size());
+}
+
+RolloutResult rollout(const Board& board, const PlayoutPolicy& policy, const RolloutOptions& options) {
+    if (options.truncateAfter > 0 && !options.evaluator) {
+        // Checked here: on a worker thread, calling the empty evaluator would terminate the process
+        throw std::invalid_argument("Truncated rollouts need an evaluator.");
+    }
+    RolloutResult result;
+    if (options.games == 0) {
+        return result;
+    }
+    RolloutRun run(board, policy, options);
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    threads = (int)std::min<uint64_t>((uint64_t)std::max(threads, 1), (options.games + CHUNK - 1) / CHUNK);
+    if (threads == 1) {
+        run.work();
+    } else {
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) {
+            pool.emplace_back([&run] { run.work(); });
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+    }
+    if (run.error) {
+        std::rethrow_exception(run.error);
+    }
+
+    double sum = 0.0;
+    double squares = 0.0;
+    for (uint64_t game = 0; game < options.games; ++game) {
+        sum += run.equities[game];
+        squares += run.equities[game] * run.equities[game];
+        result.truncated += run.truncated[game];
+    }
+    const double n = (double)options.games;
+    result.games = options.games;
+    result.equity = sum / n;
+    if (options.games > 1) {
+        const double variance = std::max(0.0, (squares - sum * sum / n) / (n - 1));
+        result.standardError = std::sqrt(variance / n);
+    }
+    return result;
+}
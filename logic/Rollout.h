@@ -0,0 +1,85 @@
+#ifndef ROLLOUT_H
+#define ROLLOUT_H
+#include <inttypes.h>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "Board.h"
+#include "Play.h"
+#include "Rng.h"
+
+
+
+/**
+ * @file Rollout.h
+ * @brief Multi-threaded rollouts: the equity of a position estimated by playing it out many times.
+ *
+ * rollout() plays a number of games from a position, with the current player about to roll, on a
+ * pool of threads. Each thread owns a generator that is reseeded for every game from the rollout
+ * seed and the game number, so the result only depends on the options and not on the number of
+ * threads or on how games are scheduled.
+ *
+ * Two ways of reducing the variance are supported:
+ *  - Rotated dice: the rolls of the first turns are not random but stratified. Over every block of
+ *    36^T games, each sequence of T rolls is played exactly once (shuffled by the seed), so the
+ *    luck of the first turns, the largest part of the variance, averages out exactly.
+ *  - Truncation: after a number of plies the game is stopped and scored by a static evaluator,
+ *    which removes the variance of the remaining plies (and their cost).
+ *
+ * Equities are in points per game from the point of view of the player on roll at the start:
+ * +1, +2 or +3 for a single, gammon or backgammon win, negative for a loss (cubeless).
+ */
+
+/**
+ * @brief Chooses a play for the player on roll.
+ * Called concurrently from every rollout thread, so it must be thread-safe.
+ * @param board The board, with the dice already rolled.
+ * @param plays The legal plays (at least one; a single empty play when the roll cannot be played).
+ * @param rng The generator of the calling thread, for randomized policies.
+ * @return The index of the chosen play.
+ */
+typedef std::function<size_t(const Board& board, const std::vector<Play>& plays, Rng& rng)> PlayoutPolicy;
+
+/**
+ * @brief Scores a position where a rollout is truncated.
+ * Called concurrently from every rollout thread, so it must be thread-safe.
+ * @param board The board, with the player on roll not having rolled yet (no dice).
+ * @return The expected outcome in Board::getOutcome units (positive favours player 1).
+ */
+typedef std::function<double(const Board& board)> RolloutEvaluator;
+
+struct RolloutOptions {
+    uint64_t games = 1296;         // Number of games (a multiple of 36^rotatedTurns balances the rotation)
+    int threads = 0;               // Worker threads, 0 for one per hardware thread
+    uint64_t seed = 0;             // Seed of the dice and of the policy's generator
+    int rotatedTurns = 2;          // Turns with rotated dice, 0 for plain random dice
+    int truncateAfter = 0;         // Plies played before scoring with the evaluator, 0 to play out every game
+    RolloutEvaluator evaluator;    // Required when truncateAfter is greater than 0
+};
+
+struct RolloutResult {
+    double equity = 0.0;        // Mean equity of the player on roll
+    double standardError = 0.0; // Standard error of the mean (an upper bound with rotated dice)
+    uint64_t games = 0;         // Games played
+    uint64_t truncated = 0;     // Games scored by the evaluator
+};
+
+/**
+ * @brief Chooses a legal play uniformly at random.
+ */
+size_t randomPolicy(const Board& board, const std::vector<Play>& plays, Rng& rng);
+
+/**
+ * @brief Rolls out a position.
+ * An exception thrown by the policy or the evaluator stops the rollout and is rethrown here once every
+ * thread has stopped (the first one if several threads throw), whatever the number of threads.
+ * @param board The position. Its current player is about to roll: any dice left on the board are ignored.
+ * @param policy The policy playing both sides.
+ * @param options Number of games, threads, seed and variance reduction settings.
+ * @return The mean equity of the current player and its standard error.
+ * @throws std::invalid_argument if options.truncateAfter is greater than 0 and there is no evaluator.
+ */
+RolloutResult rollout(const Board& board, const PlayoutPolicy& policy, const RolloutOptions& options = RolloutOptions());
+
+
+#endif // ROLLOUT_H
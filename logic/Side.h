@@ -0,0 +1,75 @@
+#ifndef SIDE_H
+#define SIDE_H
+#include <inttypes.h>
+
+
+
+/**
+ * @file Side.h
+ * @brief Compile-time description of how each player moves.
+ *
+ * Move generation and move application are written once as templates on the player
+ * (1 or -1) and read everything that differs between the two players from Side<Player>:
+ * direction of travel, home board, bar entry point and bear-off edge. The player to move
+ * is checked once at the top of a turn and the whole search below runs on one instantiation.
+ *
+ * Player 1 moves from position 0 to 23 and bears off past 23; player 2 moves from 23 to 0
+ * and bears off past 0.
+ */
+template <int Player>
+struct Side {
+    static_assert(Player == 1 || Player == -1, "Player must be 1 or -1");
+
+    static constexpr int INDEX = (Player == 1) ? 0 : 1; // Side index in Position arrays
+    static constexpr int OPPONENT = 1 - INDEX;          // Opponent's side index
+    static constexpr int DIRECTION = Player;            // Sign of the distance of a move
+
+    static constexpr uint32_t ALL_POINTS = 0xFFFFFFu;
+    static constexpr uint32_t HOME = (Player == 1) ? 0xFC0000u : 0x00003Fu; // Points 18-23 or 0-5
+    static constexpr uint32_t OUTSIDE_HOME = ALL_POINTS & ~HOME;
+    static constexpr uint32_t OPPONENT_HOME = (Player == 1) ? 0x00003Fu : 0xFC0000u;
+
+    /**
+     * @brief Returns the point a piece from the bar enters on with a die.
+     */
+    static constexpr int entryPoint(int die) { return (Player == 1) ? die - 1 : 24 - die; }
+
+    /**
+     * @brief Returns the die used to enter from the bar onto a point.
+     */
+    static constexpr int entryDie(int point) { return (Player == 1) ? point + 1 : 24 - point; }
+
+    /**
+     * @brief Returns the point a die bears off from exactly.
+     */
+    static constexpr int bearOffPoint(int die) { return (Player == 1) ? 24 - die : die - 1; }
+
+    /**
+     * @brief Checks whether a target point is still on the board (otherwise the piece is borne off).
+     */
+    static constexpr bool onBoard(int point) { return (Player == 1) ? point < 24 : point >= 0; }
+
+    /**
+     * @brief Returns the mask of points further from the bear-off edge than a point.
+     */
+    static constexpr uint32_t furtherThan(int point) {
+        return (Player == 1) ? (1u << point) - 1 : ALL_POINTS & ~((2u << point) - 1);
+    }
+
+    /**
+     * @brief Returns the mask of points closer to the bear-off edge than a point.
+     */
+    static constexpr uint32_t closerThan(int point) {
+        return (Player == 1) ? ALL_POINTS & ~((2u << point) - 1) : (1u << point) - 1;
+    }
+
+    /**
+     * @brief Returns the point of a non-empty mask that is furthest from the bear-off edge.
+     */
+    static int furthest(uint32_t mask) {
+        return (Player == 1) ? __builtin_ctz(mask) : 31 - __builtin_clz(mask);
+    }
+};
+
+
+#endif // SIDE_H
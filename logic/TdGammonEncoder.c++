@@ -0,0 +1,112 @@
+#include "TdGammonEncoder.h"
+#include "NeuralNet.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+static_assert(TD_GAMMON_INPUTS == NeuralNet::TD_GAMMON_INPUTS, "NeuralNet expects the TD-Gammon encoding");
+
+namespace {
+
+// The units of the points, bar and borne off checkers of a side start at its block
+inline int blockOf(const Position& position, int side) {
+    return side == Position::sideIndex(position.currentPlayer) ? 0 : TD_GAMMON_SIDE_INPUTS;
+}
+
+// The bar, borne off and player to move units, shared by every variant
+inline void encodeCounters(const Position& position, float* inputs) {
+    for (int side = 0; side < 2; ++side) {
+        float* block = inputs + blockOf(position, side);
+        block[96] = (float)position.bar[side] / 2.0f;
+        block[97] = (float)position.checkersOff(side) / 15.0f;
+    }
+    inputs[2 * TD_GAMMON_SIDE_INPUTS] = position.currentPlayer == 1 ? 1.0f : 0.0f;
+    inputs[2 * TD_GAMMON_SIDE_INPUTS + 1] = position.currentPlayer == 1 ? 0.0f : 1.0f;
+}
+
+// The 4 units of a point holding n checkers
+inline void pointUnits(int n, float* units) {
+    units[0] = n >= 1 ? 1.0f : 0.0f;
+    units[1] = n >= 2 ? 1.0f : 0.0f;
+    units[2] = n >= 3 ? 1.0f : 0.0f;
+    units[3] = n > 3 ? (float)(n - 3) / 2.0f : 0.0f;
+}
+
+// The 8 units of the two points packed in a byte of Position::points, low nibble first
+struct PairTable {
+    alignas(32) float units[256][8];
+
+    PairTable() {
+        for (int byte = 0; byte < 256; ++byte) {
+            pointUnits(byte & 0x0F, units[byte]);
+            pointUnits(byte >> 4, units[byte] + 4);
+        }
+    }
+};
+
+const PairTable PAIRS;
+
+// Side 1 counts its points from point 0, so byte i gives the units 8i to 8i + 7 as stored. Side 0
+// counts from point 23, so its bytes come in reverse order, with the nibbles swapped.
+inline const float* pairUnits(const Position& position, int side, int byte) {
+    const uint8_t packed = position.points[side][side == 0 ? 11 - byte : byte];
+    return PAIRS.units[side == 0 ? (uint8_t)((packed >> 4) | (packed << 4)) : packed];
+}
+
+} // namespace
+
+void encodeTdGammonScalar(const Board* boards, size_t count, float* inputs) {
+    for (size_t b = 0; b < count; ++b, inputs += TD_GAMMON_INPUTS) {
+        const Position& position = boards[b].position();
+        for (int side = 0; side < 2; ++side) {
+            float* block = inputs + blockOf(position, side);
+            for (int point = 0; point < 24; ++point) {
+                const int distance = Position::pipDistance(side, point);
+                pointUnits(position.count(side, point), block + 4 * (distance - 1));
+            }
+        }
+        encodeCounters(position, inputs);
+    }
+}
+
+#if defined(__x86_64__)
+
+void encodeTdGammonSse2(const Board* boards, size_t count, float* inputs) {
+    for (size_t b = 0; b < count; ++b, inputs += TD_GAMMON_INPUTS) {
+        const Position& position = boards[b].position();
+        for (int side = 0; side < 2; ++side) {
+            float* block = inputs + blockOf(position, side);
+            for (int byte = 0; byte < 12; ++byte) {
+                const float* units = pairUnits(position, side, byte);
+                _mm_storeu_ps(block + 8 * byte, _mm_load_ps(units));
+                _mm_storeu_ps(block + 8 * byte + 4, _mm_load_ps(units + 4));
+            }
+        }
+        encodeCounters(position, inputs);
+    }
+}
+
+__attribute__((target("avx2")))
+void encodeTdGammonAvx2(const Board* boards, size_t count, float* inputs) {
+    for (size_t b = 0; b < count; ++b, inputs += TD_GAMMON_INPUTS) {
+        const Position& position = boards[b].position();
+        for (int side = 0; side < 2; ++side) {
+            float* block = inputs + blockOf(position, side);
+            for (int byte = 0; byte < 12; ++byte) {
+                _mm256_storeu_ps(block + 8 * byte, _mm256_load_ps(pairUnits(position, side, byte)));
+            }
+        }
+        encodeCounters(position, inputs);
+    }
+}
+
+#endif
+
+TdGammonEncoder tdGammonEncoder() {
+#if defined(__x86_64__)
+    static const TdGammonEncoder encoder = __builtin_cpu_supports("avx2") ? encodeTdGammonAvx2 : encodeTdGammonSse2;
+    return encoder;
+#else
+    return encodeTdGammonScalar;
+#endif
+}
@@ -0,0 +1,69 @@
+#ifndef TDGAMMONENCODER_H
+#define TDGAMMONENCODER_H
+#include <inttypes.h>
+#include <cstddef>
+#include "Board.h"
+
+
+
+/**
+ * @file TdGammonEncoder.h
+ * @brief Tesauro's 198-input encoding of a board, the input layer of NeuralNet.
+ *
+ * Each side is encoded seen from its own end of the board, the side to move first:
+ *   - 24 points, from the side's 1-point (1 pip from bearing off) to its 24-point, 4 units each:
+ *     n checkers give 1 in the first unit if n >= 1, in the second if n >= 2, in the third if n >= 3,
+ *     and (n - 3) / 2 in the fourth;
+ *   - checkers on the bar / 2;
+ *   - checkers borne off / 15.
+ * The last 2 units are 1 if player 1 is to move and 1 if player 2 is to move. The dice are not encoded.
+ *
+ * The units of two neighbouring points only depend on the byte holding both 4-bit counts in
+ * Position, so the vector kernels look every byte up in a table of 256 rows of 8 floats and copy
+ * the row (two SSE2 stores, or one AVX2 store) instead of computing the units point by point.
+ * tdGammonEncoder() picks the widest variant the CPU supports the first time it is called; the
+ * scalar version is the reference and the fallback on other architectures.
+ */
+
+static constexpr int TD_GAMMON_SIDE_INPUTS = 98; // Units per side: 24 points, bar and borne off
+static constexpr int TD_GAMMON_INPUTS = 2 * TD_GAMMON_SIDE_INPUTS + 2;
+
+/**
+ * @brief Encodes boards one after the other into count rows of TD_GAMMON_INPUTS floats.
+ */
+typedef void (*TdGammonEncoder)(const Board* boards, size_t count, float* inputs);
+
+/**
+ * @brief Reference implementation, one unit at a time.
+ */
+void encodeTdGammonScalar(const Board* boards, size_t count, float* inputs);
+
+#if defined(__x86_64__)
+/**
+ * @brief SSE2 table lookups, 2 points per pair of stores (SSE2 is part of every x86-64 CPU).
+ */
+void encodeTdGammonSse2(const Board* boards, size_t count, float* inputs);
+
+/**
+ * @brief AVX2 table lookups, 2 points per store. Only call it if the CPU supports AVX2.
+ */
+void encodeTdGammonAvx2(const Board* boards, size_t count, float* inputs);
+#endif
+
+/**
+ * @brief Returns the fastest encoder supported by the CPU (checked once, at the first call).
+ */
+TdGammonEncoder tdGammonEncoder();
+
+/**
+ * @brief Encodes a board into TD_GAMMON_INPUTS floats.
+ */
+inline void encodeTdGammon(const Board& board, float* inputs) { tdGammonEncoder()(&board, 1, inputs); }
+
+/**
+ * @brief Encodes boards into a contiguous buffer of count * TD_GAMMON_INPUTS floats, a row per board.
+ */
+inline void encodeTdGammon(const Board* boards, size_t count, float* inputs) { tdGammonEncoder()(boards, count, inputs); }
+
+
+#endif // TDGAMMONENCODER_H
@@ -0,0 +1,138 @@
+#include "TranspositionTable.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t OCCUPANCY_SAMPLE = 1024; // Buckets looked at by occupancy()
+
+inline uint64_t dataAge(uint64_t data) {
+    return (data >> 42) & 0x3F;
+}
+
+inline int dataDepth(uint64_t data) {
+    return (int)((data >> 32) & 0xFF);
+}
+
+inline bool dataUsed(uint64_t data) {
+    return ((data >> 40) & 0x3) != 0; // Bounds start at 1, so an empty entry has bound 0
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    const size_t wanted = (megabytes << 20) / sizeof(Bucket);
+    bucketCount = 1;
+    while (bucketCount * 2 <= wanted) {
+        bucketCount *= 2;
+    }
+    table.reset(new Bucket[bucketCount]);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t b = 0; b < bucketCount; ++b) {
+        for (int i = 0; i < BUCKET_ENTRIES; ++i) {
+            table[b].check[i].store(0, std::memory_order_relaxed);
+            table[b].data[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    age.store(0, std::memory_order_relaxed);
+    resetCounters();
+}
+
+uint64_t TranspositionTable::pack(const Entry& entry, uint64_t age) {
+    uint32_t equity;
+    std::memcpy(&equity, &entry.equity, sizeof(equity));
+    return (uint64_t)equity | ((uint64_t)entry.depth << 32) | ((uint64_t)entry.bound << 40) | (age << 42) | ((uint64_t)entry.bestPlay << 48);
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    Entry entry;
+    const uint32_t equity = (uint32_t)data;
+    std::memcpy(&entry.equity, &equity, sizeof(equity));
+    entry.depth = (uint8_t)dataDepth(data);
+    entry.bound = (Bound)((data >> 40) & 0x3);
+    entry.bestPlay = (uint16_t)(data >> 48);
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const {
+    probeCount.value.fetch_add(1, std::memory_order_relaxed);
+    const Bucket& bucket = table[key & (bucketCount - 1)];
+    for (int i = 0; i < BUCKET_ENTRIES; ++i) {
+        const uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+        if (dataUsed(data) && (bucket.check[i].load(std::memory_order_relaxed) ^ data) == key) {
+            entry = unpack(data);
+            hitCount.value.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const Entry& entry) {
+    storeCount.value.fetch_add(1, std::memory_order_relaxed);
+    Bucket& bucket = table[key & (bucketCount - 1)];
+    const uint64_t current = age.load(std::memory_order_relaxed);
+
+    // The entry of the same key if there is one, otherwise an empty entry, otherwise the entry
+    // with the lowest worth: depth, plus 256 for the current search so older results go first
+    int victim = 0;
+    int victimWorth = 1 << 30;
+    for (int i = 0; i < BUCKET_ENTRIES; ++i) {
+        const uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+        if (!dataUsed(data)) {
+            if (victimWorth >= 0) {
+                victim = i;
+                victimWorth = -1;
+            }
+            continue;
+        }
+        if ((bucket.check[i].load(std::memory_order_relaxed) ^ data) == key) {
+            if (dataAge(data) == current && dataDepth(data) > entry.depth) {
+                return; // A deeper result of this search is worth more
+            }
+            victim = i;
+            victimWorth = -2;
+            break;
+        }
+        const int worth = dataDepth(data) + (dataAge(data) == current ? 256 : 0);
+        if (worth < victimWorth) {
+            victim = i;
+            victimWorth = worth;
+        }
+    }
+    if (victimWorth >= 0) {
+        collisionCount.value.fetch_add(1, std::memory_order_relaxed);
+    }
+    const uint64_t data = pack(entry, current);
+    bucket.data[victim].store(data, std::memory_order_relaxed);
+    bucket.check[victim].store(key ^ data, std::memory_order_relaxed);
+}
+
+double TranspositionTable::hitRate() const {
+    const uint64_t n = probes();
+    return n ? (double)hits() / (double)n : 0.0;
+}
+
+void TranspositionTable::resetCounters() {
+    probeCount.value.store(0, std::memory_order_relaxed);
+    hitCount.value.store(0, std::memory_order_relaxed);
+    storeCount.value.store(0, std::memory_order_relaxed);
+    collisionCount.value.store(0, std::memory_order_relaxed);
+}
+
+double TranspositionTable::occupancy() const {
+    const uint64_t sample = bucketCount < OCCUPANCY_SAMPLE ? bucketCount : OCCUPANCY_SAMPLE;
+    uint64_t used = 0;
+    for (uint64_t b = 0; b < sample; ++b) {
+        for (int i = 0; i < BUCKET_ENTRIES; ++i) {
+            used += dataUsed(table[b].data[i].load(std::memory_order_relaxed)) ? 1 : 0;
+        }
+    }
+    return (double)used / (double)(sample * BUCKET_ENTRIES);
+}
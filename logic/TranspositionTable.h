@@ -0,0 +1,149 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+#include <inttypes.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+
+/**
+ * @file TranspositionTable.h
+ * @brief Fixed-size, lock-free cache of search results keyed by the 64-bit Zobrist key of a board.
+ *
+ * The table is an array of 64-byte buckets of four entries, and a key can live in any entry of the
+ * bucket selected by its low bits. An entry is two 64-bit words written and read with relaxed
+ * atomics: the data (equity, depth, bound, age and best play) and the key XOR the data. A probe
+ * accepts an entry only if the two words XOR back to the key, so an entry torn by concurrent
+ * writers reads as a miss instead of as another position's result, and no lock is ever taken.
+ *
+ * A store overwrites the entry already holding the key, unless that entry is deeper and from the
+ * current search. Otherwise it takes an empty entry or evicts the entry of the bucket that is
+ * cheapest to lose: entries from earlier searches first (see newSearch()), then the shallowest.
+ *
+ * Counters of probes, hits, stores and collisions (stores that evict another position) are kept
+ * with relaxed atomics on separate cache lines; they are exact once the searching threads stop.
+ */
+class TranspositionTable {
+    public:
+        /**
+         * @brief How the stored equity relates to the true value of the position.
+         */
+        enum class Bound : uint8_t {
+            EXACT = 1, // The value at the stored depth
+            LOWER = 2, // At least the stored equity (a search failed high)
+            UPPER = 3  // At most the stored equity (a search failed low)
+        };
+
+        struct Entry {
+            float equity;      // For the player on roll, in points
+            uint8_t depth;     // Plies searched below the position, 0 for a static evaluation
+            Bound bound;
+            uint16_t bestPlay; // Index of the best play in the order of Board::legalPlays, or NO_PLAY
+        };
+
+        static constexpr uint16_t NO_PLAY = 0xFFFF;
+        static constexpr int BUCKET_ENTRIES = 4;
+        static constexpr size_t DEFAULT_MEGABYTES = 16;
+
+        /**
+         * @brief Constructs an empty table.
+         * @param megabytes The memory to use, rounded down to a power of two number of buckets.
+         */
+        explicit TranspositionTable(size_t megabytes = DEFAULT_MEGABYTES);
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /**
+         * @brief Reallocates the table, dropping every entry. Not thread-safe.
+         */
+        void resize(size_t megabytes);
+
+        /**
+         * @brief Drops every entry and resets the counters. Not thread-safe.
+         */
+        void clear();
+
+        /**
+         * @brief Starts a new search: entries stored before become the first to be replaced.
+         */
+        void newSearch() { age.store((age.load(std::memory_order_relaxed) + 1) & AGE_MASK, std::memory_order_relaxed); }
+
+        /**
+         * @brief Looks up a position.
+         * @param key The Zobrist key of the board (Board::getKey).
+         * @param entry Set to the stored entry on a hit.
+         * @return true on a hit.
+         */
+        bool probe(uint64_t key, Entry& entry) const;
+
+        /**
+         * @brief Stores the result of a search or an evaluation.
+         * @param key The Zobrist key of the board.
+         * @param entry The result.
+         */
+        void store(uint64_t key, const Entry& entry);
+
+        /**
+         * @brief Gets the number of entries the table holds.
+         */
+        size_t capacity() const { return bucketCount * BUCKET_ENTRIES; }
+
+        /**
+         * @brief Gets the number of buckets (a power of two); keys equal modulo it share a bucket.
+         */
+        size_t buckets() const { return bucketCount; }
+
+        uint64_t probes() const { return probeCount.value.load(std::memory_order_relaxed); }
+        uint64_t hits() const { return hitCount.value.load(std::memory_order_relaxed); }
+        uint64_t stores() const { return storeCount.value.load(std::memory_order_relaxed); }
+        uint64_t collisions() const { return collisionCount.value.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Gets the share of probes that hit (0 before the first probe).
+         */
+        double hitRate() const;
+
+        /**
+         * @brief Resets the counters, keeping the entries.
+         */
+        void resetCounters();
+
+        /**
+         * @brief Gets the share of entries in use, sampled over the first buckets.
+         */
+        double occupancy() const;
+
+    private:
+        static constexpr uint64_t AGE_MASK = 0x3F;
+
+        struct alignas(64) Bucket {
+            std::atomic<uint64_t> check[BUCKET_ENTRIES]; // Key XOR data
+            std::atomic<uint64_t> data[BUCKET_ENTRIES];  // Packed entry, 0 when empty
+        };
+
+        struct alignas(64) Counter {
+            mutable std::atomic<uint64_t> value{0};
+        };
+
+        std::unique_ptr<Bucket[]> table;
+        size_t bucketCount = 0;
+        std::atomic<uint64_t> age{0}; // Age of the current search, 6 bits
+        Counter probeCount;
+        Counter hitCount;
+        Counter storeCount;
+        Counter collisionCount;
+
+        /**
+         * @brief Packs an entry: equity bits 0-31, depth 32-39, bound 40-41, age 42-47, best play 48-63.
+         */
+        static uint64_t pack(const Entry& entry, uint64_t age);
+
+        static Entry unpack(uint64_t data);
+};
+
+static_assert(sizeof(TranspositionTable::Entry) == 8, "Entries are packed into one word");
+
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,148 @@
+#include "TwoSidedBearoff.h"
+#include "BearoffDatabase.h"
+#include "PlayTree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char MAGIC[8] = "BGBEAR2";
+
+const int ROLLS = 21;
+
+} // namespace
+
+bool TwoSidedBearoff::generate(const std::string& path, int checkers) {
+    if (checkers < 1 || checkers > MAX_CHECKERS) {
+        return false;
+    }
+    const uint32_t positions = BearoffDatabase::positionCount(checkers);
+
+    // Successors of every one-sided position for every roll, flattened; positions are bucketed by pips
+    std::vector<uint32_t> first(positions * ROLLS + 1);
+    std::vector<uint32_t> successors;
+    std::vector<double> weights;
+    for (int high = 1; high <= 6; ++high) {
+        for (int low = 1; low <= high; ++low) {
+            weights.push_back((high == low ? 1.0 : 2.0) / 36.0);
+        }
+    }
+    std::vector<std::vector<uint32_t>> byPips(BearoffDatabase::POINTS * checkers + 1);
+    PlayTree tree;
+    std::vector<uint32_t> next;
+    for (uint32_t i = 0; i < positions; ++i) {
+        uint8_t counts[BearoffDatabase::POINTS];
+        BearoffDatabase::counts(i, counts);
+        int pips = 0;
+        for (int j = 0; j < BearoffDatabase::POINTS; ++j) {
+            pips += counts[j] * (j + 1);
+        }
+        byPips[pips].push_back(i);
+        int roll = 0;
+        for (int high = 1; high <= 6; ++high) {
+            for (int low = 1; low <= high; ++low, ++roll) {
+                first[i * ROLLS + roll] = (uint32_t)successors.size();
+                if (i == 0) {
+                    continue; // Already borne off
+                }
+                BearoffDatabase::successors(counts, high, low, tree, next);
+                successors.insert(successors.end(), next.begin(), next.end());
+            }
+        }
+    }
+    first[positions * ROLLS] = (uint32_t)successors.size();
+
+    // value[onRoll * positions + opponent]: a side with nothing left has already won, and a side
+    // on roll against such an opponent has lost
+    std::vector<float> value(positions * positions, 0.0f);
+    for (uint32_t opponent = 0; opponent < positions; ++opponent) {
+        value[opponent] = 1.0f;
+    }
+    const int maxPips = (int)byPips.size() - 1;
+    for (int total = 2; total <= 2 * maxPips; ++total) {
+        for (int pips = 1; pips < total; ++pips) {
+            if (pips > maxPips || total - pips > maxPips) {
+                continue;
+            }
+            for (uint32_t onRoll : byPips[pips]) {
+                for (uint32_t opponent : byPips[total - pips]) {
+                    // Every play leads to a pair with fewer pips in total, solved already
+                    double chance = 0.0;
+                    for (int roll = 0; roll < ROLLS; ++roll) {
+                        double best = 0.0;
+                        for (uint32_t s = first[onRoll * ROLLS + roll]; s < first[onRoll * ROLLS + roll + 1]; ++s) {
+                            const uint32_t played = successors[s];
+                            const double win = (played == 0) ? 1.0 : 1.0 - value[opponent * positions + played];
+                            best = std::max(best, win);
+                        }
+                        chance += weights[roll] * best;
+                    }
+                    value[onRoll * positions + opponent] = (float)chance;
+                }
+            }
+        }
+    }
+
+    std::vector<uint16_t> quantized(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        quantized[i] = (uint16_t)std::lround(value[i] * 65535.0);
+    }
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.checkers = (uint32_t)checkers;
+    header.positions = positions;
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    ok = ok && std::fwrite(quantized.data(), sizeof(uint16_t), quantized.size(), out) == quantized.size();
+    return std::fclose(out) == 0 && ok;
+}
+
+bool TwoSidedBearoff::open(const std::string& path) {
+    if (!file.open(path)) {
+        return false;
+    }
+    if (file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    const Header& h = header();
+    const bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.checkers >= 1 && h.checkers <= MAX_CHECKERS
+                    && h.positions == BearoffDatabase::positionCount((int)h.checkers)
+                    && file.size() >= sizeof(Header) + (size_t)h.positions * h.positions * sizeof(uint16_t);
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+int TwoSidedBearoff::checkers() const {
+    return (int)header().checkers;
+}
+
+uint32_t TwoSidedBearoff::size() const {
+    return header().positions;
+}
+
+bool TwoSidedBearoff::contains(const Position& position) const {
+    for (int side = 0; side < 2; ++side) {
+        if (position.highestPoint(side) > BearoffDatabase::POINTS || position.inPlay[side] > header().checkers) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double TwoSidedBearoff::winProbability(uint32_t onRoll, uint32_t opponent) const {
+    return values()[(size_t)onRoll * header().positions + opponent] / 65535.0;
+}
+
+double TwoSidedBearoff::winProbability(const Position& position) const {
+    const int side = Position::sideIndex(position.currentPlayer);
+    return winProbability(BearoffDatabase::index(position, side), BearoffDatabase::index(position, side ^ 1));
+}
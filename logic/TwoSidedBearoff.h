@@ -0,0 +1,98 @@
+#ifndef TWOSIDEDBEAROFF_H
+#define TWOSIDEDBEAROFF_H
+#include <inttypes.h>
+#include <string>
+#include "Position.h"
+#include "MappedFile.h"
+
+
+
+/**
+ * @file TwoSidedBearoff.h
+ * @brief Two-sided bear-off database: exact cubeless winning chances when both sides are bearing off.
+ *
+ * A two-sided position is a pair of one-sided positions (see BearoffDatabase), the side on roll and
+ * its opponent, each with at most a few checkers in its home board. generate() solves every pair by
+ * retrograde analysis: the chance of the side on roll is the average over the 21 rolls of the best
+ * play, where a play either bears off the last checker (a win) or leaves the opponent on roll in
+ * a position with fewer pips in total. Pairs are solved in increasing order of total pips, so every
+ * value a pair needs is known when it is reached. Plays come from BearoffDatabase::successors and
+ * follow the engine's move generation.
+ *
+ * File layout (little-endian):
+ *   Header       magic "BGBEAR2", checkers, positions per side
+ *   Values       positions x positions chances of the side on roll as 16-bit fractions of 65535,
+ *                the row being the side on roll and the column its opponent
+ *
+ * The values are read straight from the mapping, so a lookup is an index computation and a load.
+ */
+class TwoSidedBearoff {
+    public:
+        static constexpr int DEFAULT_CHECKERS = 6;
+        static constexpr int MAX_CHECKERS = 8; // 3003 x 3003 pairs, an 18 MB file
+
+        TwoSidedBearoff() = default;
+        TwoSidedBearoff(const TwoSidedBearoff&) = delete;
+        TwoSidedBearoff& operator=(const TwoSidedBearoff&) = delete;
+
+        /**
+         * @brief Solves the database and writes it to a file.
+         * @param path The file to write.
+         * @param checkers The most checkers each side may have (1 to MAX_CHECKERS).
+         * @return false if the file could not be written.
+         */
+        static bool generate(const std::string& path, int checkers = DEFAULT_CHECKERS);
+
+        /**
+         * @brief Maps a database file read-only.
+         * @return false if the file is missing or not a two-sided bear-off database.
+         */
+        bool open(const std::string& path);
+
+        void close() { file.close(); }
+
+        bool isOpen() const { return file.data() != nullptr; }
+
+        /**
+         * @brief Gets the most checkers each side of a position of the database may have.
+         */
+        int checkers() const;
+
+        /**
+         * @brief Gets the number of one-sided positions per side.
+         */
+        uint32_t size() const;
+
+        /**
+         * @brief Checks whether a position can be looked up: both sides have every checker in their
+         * home board and no more checkers than the database holds.
+         */
+        bool contains(const Position& position) const;
+
+        /**
+         * @brief Gets the chance that the side on roll wins, before it rolls.
+         * @param onRoll The BearoffDatabase::index of the side on roll.
+         * @param opponent The BearoffDatabase::index of its opponent.
+         */
+        double winProbability(uint32_t onRoll, uint32_t opponent) const;
+
+        /**
+         * @brief Gets the chance that the current player of a position wins, before it rolls (see contains()).
+         */
+        double winProbability(const Position& position) const;
+
+    private:
+        struct Header {
+            char magic[8];      // "BGBEAR2"
+            uint32_t checkers;  // Most checkers per side
+            uint32_t positions; // One-sided positions per side
+        };
+
+        MappedFile file;
+
+        const Header& header() const { return *(const Header*)file.data(); }
+        const uint16_t* values() const { return (const uint16_t*)(file.data() + sizeof(Header)); }
+};
+
+
+#endif // TWOSIDEDBEAROFF_H
@@ -0,0 +1,61 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+#include <inttypes.h>
+
+
+
+/**
+ * @file Zobrist.h
+ * @brief Random keys for Zobrist hashing of backgammon positions.
+ *
+ * A position key is the XOR of one key per (side, point, checker count), one per
+ * (side, bar count), one per (die face, dice left of that face) and a side-to-move key.
+ * The keys for a count of zero are zero, so empty points, empty bars and used dice
+ * contribute nothing and the key can be updated with two XORs per changed count.
+ *
+ * The tables are generated at compile time from a fixed seed, so keys are identical
+ * across runs, builds and threads.
+ */
+struct ZobristKeys {
+    uint64_t points[2][24][16]; // Indexed by side, point and checker count
+    uint64_t bar[2][16];        // Indexed by side and number of checkers on the bar
+    uint64_t dice[6][5];        // Indexed by die face - 1 and number of dice left with that face
+    uint64_t player2ToMove;     // XORed in when player 2 (-1) is to move
+};
+
+/**
+ * @brief Builds the key tables with splitmix64 from a fixed seed.
+ */
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    uint64_t seed = 0x4261636b67616d6dull; // Fixed seed so keys are reproducible
+    auto next = [&seed]() {
+        seed += 0x9e3779b97f4a7c15ull;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    };
+    for (int side = 0; side < 2; ++side) {
+        for (int point = 0; point < 24; ++point) {
+            for (int n = 1; n < 16; ++n) {
+                keys.points[side][point][n] = next();
+            }
+        }
+        for (int n = 1; n < 16; ++n) {
+            keys.bar[side][n] = next();
+        }
+    }
+    for (int face = 0; face < 6; ++face) {
+        for (int n = 1; n < 5; ++n) {
+            keys.dice[face][n] = next();
+        }
+    }
+    keys.player2ToMove = next();
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = makeZobristKeys();
+
+
+#endif // ZOBRIST_H